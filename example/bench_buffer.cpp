@@ -0,0 +1,58 @@
+#include "../source/net/muduo/package/Buffer.hpp"
+#include <chrono>
+#include <cstring>
+#include <string>
+
+// 对比输入缓冲区两种存储布局在流水线流量下的吞吐:
+// 每次读入一段数据后按完整的帧取走, 末尾总剩下半个帧
+// 1. LINEAR: 尾部空间不足时把剩下的半个帧前移到头部
+// 2. RING: 环形布局, 剩下的数据留在原地, 只移动下标
+
+static double bench(muduo::Buffer::Mode mode, size_t read_size, size_t frame_size, size_t total) {
+    muduo::BufferPool pool;
+    muduo::Buffer buffer(&pool, mode);
+    std::string chunk(read_size, 'x');
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t done = 0; done < total; done += read_size) {
+        //模拟 readv 直接读入空闲区间
+        buffer.reserve(read_size);
+        struct iovec vec[2];
+        int count = buffer.write_spans(vec);
+        size_t remain = read_size;
+        for (int i = 0; i < count && remain > 0; i++) {
+            size_t len = std::min(remain, vec[i].iov_len);
+            memcpy(vec[i].iov_base, chunk.data(), len);
+            remain -= len;
+        }
+        buffer.move_write(read_size);
+        //模拟协议层取走所有完整的帧
+        size_t frames = buffer.read_able_size() / frame_size;
+        checksum += *buffer.get_read_idx();
+        buffer.move_read(frames * frame_size);
+    }
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (checksum == 0) {
+        printf("unexpected checksum\n");
+    }
+    return total / cost / (1024 * 1024);
+}
+
+int main() {
+    logging.set_log_level("warning");
+    size_t read_sizes[] = { 4096, 16384, 60000 };
+    size_t frame_sizes[] = { 100, 7000, 30000 };
+    size_t total = 2ULL << 30;
+    for (size_t read_size : read_sizes) {
+        for (size_t frame_size : frame_sizes) {
+            double linear = 0, ring = 0;
+            for (int i = 0; i < 3; i++) {
+                linear = std::max(linear, bench(muduo::Buffer::LINEAR, read_size, frame_size, total));
+                ring = std::max(ring, bench(muduo::Buffer::RING, read_size, frame_size, total));
+            }
+            printf("read %6zu frame %5zu: linear %8.0f MB/s, ring %8.0f MB/s, %.2fx\n",
+                read_size, frame_size, linear, ring, ring / linear);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "../source/net/muduo/package/Epoller.hpp"
+#include <chrono>
+#include <fcntl.h>
+#include <unordered_map>
+#include <sys/socket.h>
+
+// 对比 Epoller 热路径的两种实现, 单个loop每秒能分发的事件数:
+// 1. 旧实现: 每次 update/remove 先 fcntl(F_GETFD) 检查描述符, wait 时通过 unordered_map 由 fd 找到 channel
+// 2. 新实现: channel 自己记录是否已注册, epoll_event.data.ptr 直接指向 channel
+// 每个场景都让所有描述符保持可读(水平触发), 分别测试只分发事件, 以及每个事件再修改一次关心的事件
+
+namespace bench
+{
+    //基线版本的 Epoller, 与改动前的实现保持一致
+    class LegacyEpoller
+    {
+    private:
+        int epoll_fd;
+        std::vector<epoll_event> events;
+        std::unordered_map<int, muduo::Channel*> channels;
+
+    public:
+        LegacyEpoller()
+            : epoll_fd(epoll_create(true)), events(65535) {}
+
+        ~LegacyEpoller() {
+            close(epoll_fd);
+        }
+
+        void update(muduo::Channel* _channel) {
+            bool ret = channels.find(_channel->get_fd()) != channels.end();
+            int fd = _channel->get_fd();
+            if (fcntl(fd, F_GETFD) == -1) {
+                return;
+            }
+            epoll_event event;
+            event.data.fd = fd;
+            event.events = _channel->get_event();
+            if (ret == false) {
+                if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0) {
+                    channels.emplace(fd, _channel);
+                }
+            }
+            else {
+                epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+            }
+        }
+
+        void remove(muduo::Channel* _channel) {
+            int fd = _channel->get_fd();
+            if (fcntl(fd, F_GETFD) == -1) {
+                return;
+            }
+            channels.erase(fd);
+            epoll_event event;
+            event.data.fd = fd;
+            event.events = _channel->get_event();
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &event);
+        }
+
+        void wait(std::vector<muduo::Channel*>& _active, int _timeout) {
+            int n = epoll_wait(epoll_fd, events.data(), events.size(), _timeout);
+            for (int i = 0; i < n; i++) {
+                auto it = channels.find(events[i].data.fd);
+                it->second->set_event(events[i].events);
+                _active.emplace_back(it->second);
+            }
+        }
+    };
+
+    //Channel::update/remove 正常由 EventLoop 转发, 这里直接转发到当前测试的 epoller
+    std::function<void(muduo::Channel*)> update_hook;
+    std::function<void(muduo::Channel*)> remove_hook;
+}
+
+void muduo::Channel::update() {
+    bench::update_hook(this);
+}
+
+void muduo::Channel::remove() {
+    bench::remove_hook(this);
+}
+
+template <typename EpollerType>
+static double bench_loop(int fd_count, int rounds, bool with_update) {
+    EpollerType epoller;
+    bench::update_hook = [&epoller](muduo::Channel* _channel) { epoller.update(_channel); };
+    bench::remove_hook = [&epoller](muduo::Channel* _channel) { epoller.remove(_channel); };
+
+    std::vector<int> peers;
+    std::vector<std::unique_ptr<muduo::Channel>> channels;
+    uint64_t handled = 0;
+    for (int i = 0; i < fd_count; i++) {
+        int fds[2];
+        socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+        //写入一个字节且从不读取, 描述符一直处于可读状态
+        ::send(fds[0], "x", 1, 0);
+        peers.push_back(fds[0]);
+        muduo::Channel* channel = new muduo::Channel(fds[1], nullptr);
+        channel->set_read_cb([&handled, channel, with_update]() {
+            handled++;
+            //模拟发送路径上 enable_write/disable_write 引起的一次 EPOLL_CTL_MOD
+            if (with_update) {
+                channel->enable_read();
+            }
+        });
+        channel->enable_read();
+        channels.emplace_back(channel);
+    }
+
+    std::vector<muduo::Channel*> actives;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        actives.clear();
+        epoller.wait(actives, 0);
+        for (auto& active : actives) {
+            active->handler_event();
+        }
+    }
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto& channel : channels) {
+        channel->remove();
+        close(channel->get_fd());
+    }
+    for (int fd : peers) {
+        close(fd);
+    }
+    return handled / cost;
+}
+
+int main() {
+    logging.set_log_level("warning");
+    int fd_counts[] = { 16, 256, 4096 };
+    for (bool with_update : { false, true }) {
+        for (int fd_count : fd_counts) {
+            int rounds = (with_update ? 200000 : 2000000) / fd_count;
+            //交替运行取最好成绩, 降低调度抖动的影响
+            double legacy_eps = 0, ptr_eps = 0;
+            for (int i = 0; i < 5; i++) {
+                legacy_eps = std::max(legacy_eps, bench_loop<bench::LegacyEpoller>(fd_count, rounds, with_update));
+                ptr_eps = std::max(ptr_eps, bench_loop<muduo::Epoller>(fd_count, rounds, with_update));
+            }
+            printf("%-14s fds %5d: fcntl+map %10.0f ev/s, data.ptr %10.0f ev/s, %.2fx\n",
+                with_update ? "dispatch+mod" : "dispatch", fd_count, legacy_eps, ptr_eps, ptr_eps / legacy_eps);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include "../source/util/Log.hpp"
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+// 多个线程同时写 info 日志时每秒能写出的行数
+// 日志仍按 SCREEN 方式写标准输出, 但标准输出先指向 /dev/null, 终端上只有打印到标准错误的结果
+
+static double bench(int threads, int lines) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([t, lines]() {
+            for (int i = 0; i < lines; i++) {
+                LOG_INFO("新连接建立: thread %d, fd %d, peer 127.0.0.1:%d", t, i, 40000 + i % 20000);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    logging.flush();
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return threads * lines / cost;
+}
+
+int main() {
+    int null_fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    if (null_fd < 0 || dup2(null_fd, STDOUT_FILENO) < 0) {
+        perror("redirect stdout");
+        return 1;
+    }
+    close(null_fd);
+    logging.set_log_level("info");
+    const int lines = 500000;
+    for (int threads : { 1, 4 }) {
+        fprintf(stderr, "%d threads: %10.0f lines/s\n", threads, bench(threads, lines));
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "../source/net/muduo/package/Buffer.hpp"
+#include "../source/net/muduo/package/Socket.hpp"
+#include <chrono>
+#include <string>
+#include <sys/socket.h>
+
+// 对比 Connection::handler_read 的两种读路径:
+// 1. 旧路径: recv 到栈上 64KB 的中转区, 再 Buffer::write 拷贝进缓冲区
+// 2. 新路径: readv 直接读入 Buffer 的尾部空闲空间, 栈上的区域只承接溢出部分
+
+static const int buffer_size = 65536;
+
+static void write_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t ret = ::send(fd, data.data() + sent, data.size() - sent, 0);
+        if (ret > 0) {
+            sent += ret;
+        }
+    }
+}
+
+static void read_by_recv(muduo::Socket& sock, muduo::Buffer& buffer) {
+    char buf[buffer_size];
+    ssize_t ret = sock.non_block_recv(buf, buffer_size - 1);
+    if (ret > 0) {
+        buffer.write(buf, ret);
+    }
+}
+
+static void read_by_readv(muduo::Socket& sock, muduo::Buffer& buffer) {
+    char extra_buf[buffer_size];
+    size_t write_able = buffer.write_able_size();
+    struct iovec vec[2];
+    vec[0].iov_base = buffer.get_write_idx();
+    vec[0].iov_len = write_able;
+    vec[1].iov_base = extra_buf;
+    vec[1].iov_len = sizeof(extra_buf);
+    ssize_t ret = sock.readv(vec, write_able >= sizeof(extra_buf) ? 1 : 2);
+    if (ret <= 0) {
+        return;
+    }
+    if (static_cast<size_t>(ret) <= write_able) {
+        buffer.move_write(ret);
+    }
+    else {
+        buffer.move_write(write_able);
+        buffer.write(extra_buf, ret - write_able);
+    }
+}
+
+template <typename ReadFunc>
+static double bench(size_t msg_size, int rounds, ReadFunc read_func) {
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    muduo::Socket reader(fds[1], muduo::Socket::IPV4_TCP);
+    muduo::Buffer buffer;
+    reader.non_block();
+    std::string payload(msg_size, 'x');
+
+    double cost = 0;
+    for (int i = 0; i < rounds; i++) {
+        write_all(fds[0], payload);
+        auto start = std::chrono::steady_clock::now();
+        size_t total = 0;
+        while (total < msg_size) {
+            size_t before = buffer.read_able_size();
+            read_func(reader, buffer);
+            total += buffer.read_able_size() - before;
+            //模拟协议层把完整的消息取走
+            buffer.move_read(buffer.read_able_size());
+        }
+        cost += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    close(fds[0]);
+    return msg_size * rounds / cost / (1024 * 1024);
+}
+
+int main() {
+    logging.set_log_level("warning");
+    size_t sizes[] = { 64, 1024, 16 * 1024, 128 * 1024 };
+    for (size_t size : sizes) {
+        int rounds = size >= 16 * 1024 ? 10000 : 50000;
+        //交替运行取最好成绩, 降低调度抖动的影响
+        double recv_mbs = 0, readv_mbs = 0;
+        for (int i = 0; i < 5; i++) {
+            recv_mbs = std::max(recv_mbs, bench(size, rounds, read_by_recv));
+            readv_mbs = std::max(readv_mbs, bench(size, rounds, read_by_readv));
+        }
+        printf("msg %7zu B: recv+copy %9.1f MB/s, readv %9.1f MB/s, %.2fx\n", size, recv_mbs, readv_mbs, readv_mbs / recv_mbs);
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "../source/net/factory/ServerFactory.hpp"
+#include "../source/net/factory/ClientFactory.hpp"
+#include "../source/net/factory/MessageFactory.hpp"
+#include <chrono>
+#include <future>
+
+// 对比同一台机器上三种传输方式收发小消息的速率:
+// 1. tcp: 回环网卡上的 TCP 连接
+// 2. unix: unix 套接字
+// 3. shm: 共享内存环, 对端忙时不经过内核, 只有对端空闲时才通过 eventfd 唤醒
+// 服务端原样回送收到的 RpcRequest, 客户端保持 window 个请求在途, 每收到一个响应就发出下一个请求
+// window 为1时相当于逐个同步调用, 测的是往返延迟
+
+// MuduoClient 析构时不等待它的loop线程退出, 测试结束前一直保留客户端
+static std::vector<rpc::BaseClient::ptr> clients;
+
+static double bench(const std::string& ip, int port, int window, int total) {
+    auto client = rpc::ClientFactory::create(ip, port);
+    clients.push_back(client);
+    auto request = rpc::MessageFactory::create<rpc::RpcRequest>();
+    request->set_id(1);
+    request->set_type(rpc::MsgType::REQ_RPC);
+    request->set_method("Add");
+    std::vector<rpc::PBValue> params(2);
+    params[0].set_number_value(11);
+    params[1].set_number_value(22);
+    request->set_params(params);
+
+    std::promise<void> done;
+    int received = 0;
+    std::atomic<int> sent(0);
+    client->set_message_cb([&](const rpc::BaseConnection::ptr& conn, const rpc::BaseMessage::ptr&) {
+        if (++received == total) {
+            done.set_value();
+        }
+        else if (sent++ < total) {
+            conn->send(request);
+        }
+    });
+    client->connect();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < window && sent++ < total; i++) {
+        client->send(request);
+    }
+    done.get_future().wait();
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    client->shutdown();
+    return total / cost;
+}
+
+int main() {
+    logging.set_log_level("warning");
+    int port = 37000 + getpid() % 1000;
+    std::string unix_ip = "unix:/tmp/bench_transport_" + std::to_string(getpid()) + ".sock";
+    std::string shm_ip = "shm:/tmp/bench_transport_" + std::to_string(getpid()) + ".shm";
+
+    auto echo = [](const rpc::BaseConnection::ptr& conn, const rpc::BaseMessage::ptr& msg) {
+        conn->send(msg);
+    };
+    rpc::BaseServer::ptr server = rpc::ServerFactory::create(port, "127.0.0.1");
+    server->add_listen(0, unix_ip);
+    server->set_message_cb(echo);
+    rpc::BaseServer::ptr shm_server = rpc::ServerFactory::create(0, shm_ip);
+    shm_server->set_message_cb(echo);
+    std::thread([server]() { server->start(); }).detach();
+    std::thread([shm_server]() { shm_server->start(); }).detach();
+    usleep(100000);
+
+    const int total = 200000;
+    for (int window : { 1, 32 }) {
+        double tcp = bench("127.0.0.1", port, window, total);
+        double uds = bench(unix_ip, 0, window, total);
+        double shm = bench(shm_ip, 0, window, total);
+        printf("window %2d: tcp %9.0f msg/s, unix %9.0f msg/s, shm %9.0f msg/s (%.2fx tcp)\n",
+            window, tcp, uds, shm, shm / tcp);
+    }
+    unlink(unix_ip.c_str() + 5);
+    unlink(shm_ip.c_str() + 4);
+    fflush(stdout);
+    _exit(0);
+}
@@ -0,0 +1,120 @@
+#include "../source/net/muduo/tcp_server/TcpServer.hpp"
+#include <chrono>
+#include <thread>
+#include <future>
+#include <pthread.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+// 对比两种事件监控后端上回显服务器每秒能处理的消息数, 以及服务端loop线程处理每条消息的CPU时间
+// 1. epoll: epoll_wait + 每个连接各自 recv/sendmsg
+// 2. io_uring: multishot recv 收进注册的缓冲区环, 回复在本轮结束时与等待合并为一次 io_uring_enter
+// 服务端只有一个loop线程; 客户端在另一个线程中用 epoll 驱动 conns 个连接, 每个连接收到回显后立即发出下一条
+
+static void run_server(uint16_t port, muduo::Epoller::Backend backend, std::promise<clockid_t>* ready) {
+    muduo::TcpServer server(port, "127.0.0.1", backend);
+    server.set_msg_cb([](const muduo::Connection::ptr& conn, muduo::Buffer* buf) {
+        conn->send(buf->read_string(buf->read_able_size()));
+    });
+    clockid_t clock;
+    pthread_getcpuclockid(pthread_self(), &clock);
+    ready->set_value(clock);
+    server.start();
+}
+
+static double thread_cpu(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 返回每秒完成的往返数, cpu_per_msg 为服务端每条消息的CPU时间(微秒)
+static double bench(uint16_t port, clockid_t server_clock, int conns, int msg_size, double seconds, double& cpu_per_msg) {
+    std::string msg(msg_size, 'x');
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<int> fds;
+    std::vector<size_t> pending(conns, 0);
+    for (int i = 0; i < conns; i++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            perror("connect");
+            exit(1);
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u32 = i;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+        fds.push_back(fd);
+    }
+    usleep(100000);
+
+    uint64_t done = 0;
+    char buf[65536];
+    double cpu_start = thread_cpu(server_clock);
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(seconds);
+    for (int i = 0; i < conns; i++) {
+        ::send(fds[i], msg.data(), msg.size(), 0);
+    }
+    struct epoll_event events[256];
+    while (std::chrono::steady_clock::now() < deadline) {
+        int n = epoll_wait(epfd, events, 256, 100);
+        for (int k = 0; k < n; k++) {
+            int i = events[k].data.u32;
+            ssize_t ret = ::recv(fds[i], buf, sizeof(buf), 0);
+            if (ret <= 0) {
+                continue;
+            }
+            pending[i] += ret;
+            while (pending[i] >= msg.size()) {
+                pending[i] -= msg.size();
+                done++;
+                ::send(fds[i], msg.data(), msg.size(), 0);
+            }
+        }
+    }
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cpu_per_msg = (thread_cpu(server_clock) - cpu_start) * 1e6 / done;
+    for (int fd : fds) {
+        close(fd);
+    }
+    close(epfd);
+    return done / cost;
+}
+
+int main() {
+    logging.set_log_level("fatal");
+    uint16_t port = 39000 + getpid() % 1000;
+    std::promise<clockid_t> epoll_ready, uring_ready;
+    std::thread(run_server, port, muduo::Epoller::EPOLL, &epoll_ready).detach();
+    std::thread(run_server, port + 1, muduo::Epoller::IO_URING, &uring_ready).detach();
+    clockid_t epoll_clock = epoll_ready.get_future().get();
+    clockid_t uring_clock = uring_ready.get_future().get();
+    usleep(100000);
+
+    for (int conns : { 1, 64, 512 }) {
+        for (int msg_size : { 64, 4096 }) {
+            //交替运行取最好成绩, 降低调度抖动的影响
+            double epoll_rate = 0, uring_rate = 0, epoll_cpu = 1e9, uring_cpu = 1e9;
+            for (int i = 0; i < 3; i++) {
+                double cpu;
+                epoll_rate = std::max(epoll_rate, bench(port, epoll_clock, conns, msg_size, 1.0, cpu));
+                epoll_cpu = std::min(epoll_cpu, cpu);
+                uring_rate = std::max(uring_rate, bench(port + 1, uring_clock, conns, msg_size, 1.0, cpu));
+                uring_cpu = std::min(uring_cpu, cpu);
+            }
+            printf("conns %3d, %4d bytes: epoll %8.0f msg/s %5.2f us/msg, io_uring %8.0f msg/s %5.2f us/msg, %.2fx\n",
+                conns, msg_size, epoll_rate, epoll_cpu, uring_rate, uring_cpu, uring_rate / epoll_rate);
+        }
+    }
+    fflush(stdout);
+    _exit(0);
+}
@@ -0,0 +1,104 @@
+#include "../source/net/muduo/tcp_server/TcpServer.hpp"
+#include <chrono>
+#include <ctime>
+#include <future>
+#include <netinet/tcp.h>
+
+// 对比大响应的两种发送路径在回环网卡上的吞吐和服务端loop线程的CPU时间:
+// 1. copy: 普通 send, 数据拷贝进套接字缓冲区
+// 2. zerocopy: 不小于阈值的数据块以 MSG_ZEROCOPY 发送, 收到完成通知后才释放
+// 客户端每发送一个字节的请求, 服务端回复一个 payload 大小的响应, 保持4个请求在途
+// 注意: 回环网卡上内核会在投递给接收端时补做拷贝, 并在完成通知中标记 COPIED,
+//       连接在收到这样的通知后会退回普通发送, 真实网卡上的收益需要跨机器测试
+
+static const int pipeline = 4;
+
+static double thread_cpu_seconds(muduo::EventLoop* loop) {
+    std::promise<double> cpu;
+    loop->run_in_loop([&cpu]() {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        cpu.set_value(ts.tv_sec + ts.tv_nsec / 1e9);
+    });
+    return cpu.get_future().get();
+}
+
+static void bench(bool zerocopy, size_t payload_size, int requests, int port) {
+    muduo::Connection::ptr server_conn;
+    std::promise<void> connected;
+    std::shared_ptr<const std::string> payload = std::make_shared<const std::string>(payload_size, 'x');
+    std::thread([&]() {
+        muduo::TcpServer server(port, "127.0.0.1");
+        if (zerocopy) {
+            server.enable_zerocopy(64 * 1024);
+        }
+        server.set_thread_count(1);
+        server.set_conn_cb([&](const muduo::Connection::ptr& conn) {
+            server_conn = conn;
+            connected.set_value();
+        });
+        server.set_msg_cb([payload](const muduo::Connection::ptr& conn, muduo::Buffer* buf) {
+            size_t n = buf->read_able_size();
+            buf->move_read(n);
+            for (size_t i = 0; i < n; i++) {
+                conn->send(std::string(*payload));
+            }
+        });
+        server.start();
+    }).detach();
+    usleep(100000);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        printf("connect failed: %s\n", strerror(errno));
+        return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    connected.get_future().wait();
+    muduo::EventLoop* loop = server_conn->get_loop();
+
+    std::vector<char> buf(1 << 20);
+    double cpu_start = thread_cpu_seconds(loop);
+    auto start = std::chrono::steady_clock::now();
+    int sent = 0;
+    size_t received = 0, expected = payload_size * requests;
+    for (; sent < pipeline && sent < requests; sent++) {
+        ::send(fd, "r", 1, 0);
+    }
+    while (received < expected) {
+        ssize_t ret = ::recv(fd, buf.data(), buf.size(), 0);
+        if (ret <= 0) {
+            printf("recv failed\n");
+            break;
+        }
+        size_t before = received / payload_size;
+        received += ret;
+        //每收完一个响应就补发一个请求
+        for (size_t done = received / payload_size; before < done && sent < requests; before++, sent++) {
+            ::send(fd, "r", 1, 0);
+        }
+    }
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cpu = thread_cpu_seconds(loop) - cpu_start;
+    printf("%-9s payload %7zu: %8.0f MB/s, server loop cpu %.3fs (%.1f us/response)\n",
+        zerocopy ? "zerocopy" : "copy", payload_size, received / cost / (1024 * 1024), cpu, cpu * 1e6 / requests);
+    close(fd);
+}
+
+int main() {
+    logging.set_log_level("warning");
+    int port = 36000 + getpid() % 1000;
+    size_t payloads[] = { 128 * 1024, 512 * 1024, 2 * 1024 * 1024 };
+    for (size_t payload : payloads) {
+        int requests = static_cast<int>((2ULL << 30) / payload);
+        bench(false, payload, requests, port++);
+        bench(true, payload, requests, port++);
+    }
+    fflush(stdout);
+    _exit(0);
+}
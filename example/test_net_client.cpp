@@ -32,7 +32,7 @@ int main() {
     client->connect();
 
     auto req = rpc::MessageFactory::create<rpc::RpcRequest>();
-    req->set_id("id");
+    req->set_id(1);
     req->set_method("method");
     req->set_params({"param1", "param2"});
     for(int i = 0; i < 1e3; i++){
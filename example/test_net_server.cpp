@@ -10,7 +10,7 @@ void on_rpc_request(const rpc::BaseConnection::ptr& conn, const rpc::BaseMessage
     std::string body = msg->serialize();
     std::cout << body << std::endl;
     auto rsp = rpc::MessageFactory::create<rpc::RpcResponse>();
-    rsp->set_id("id");
+    rsp->set_id(1);
     rsp->set_type(rpc::MsgType::RSP_RPC);
     rsp->set_retcode(rpc::RetCode::SUCCESS);
     rsp->set_result("result");
@@ -21,7 +21,7 @@ void on_topic_request(const rpc::BaseConnection::ptr& conn, const rpc::BaseMessa
     std::string body = msg->serialize();
     std::cout << body << std::endl;
     auto rsp = rpc::MessageFactory::create<rpc::TopicResponse>();
-    rsp->set_id("id");
+    rsp->set_id(1);
     rsp->set_type(rpc::MsgType::RSP_TOPIC);
     rsp->set_retcode(rpc::RetCode::SUCCESS);
     conn->send(rsp);
@@ -32,7 +32,7 @@ void on_topic_request(const rpc::BaseConnection::ptr& conn, const rpc::BaseMessa
 //     std::cout << body << std::endl;
 //     std::cout << (int)msg->get_type() << std::endl;
 //     auto rsp = rpc::MessageFactory::create<rpc::RpcResponse>();
-//     rsp->set_id("id");
+//     rsp->set_id(1);
 //     rsp->set_type(rpc::MsgType::RSP_RPC);
 //     rsp->set_retcode(rpc::RetCode::SUCCESS);
 //     rsp->set_result("result");
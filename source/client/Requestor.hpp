@@ -24,9 +24,10 @@ namespace rpc {
             void on_response(const BaseConnection::ptr& _conn, const BaseMessage::ptr& _req) {
                 auto desc = get_describe(_req->get_id());
                 if (!desc) {
-                    logging.error("Requestor::on_response 没有找到请求描述");
+                    LOG_ERROR("Requestor::on_response 没有找到请求描述");
                 }
                 else {
+                    learn_method_id(_conn, desc->request, _req);
                     if(desc->rpc_type == RpcType::ASYNC) {
                         desc->response.set_value(_req);
                     }
@@ -35,11 +36,11 @@ namespace rpc {
                             desc->callback(_req);
                         }
                         else {
-                            logging.warning("Requestor::on_response 没有回调函数");
+                            LOG_WARNING("Requestor::on_response 没有回调函数");
                         }
                     }
                     else {
-                        logging.error("Requestor::on_response 未知请求类型");
+                        LOG_ERROR("Requestor::on_response 未知请求类型");
                     }
                 }
                 remove_describe(_req->get_id());
@@ -50,7 +51,7 @@ namespace rpc {
                 AsyncResponse async_rsp;
                 bool ret = async_send(_conn, _req, async_rsp);
                 if (!ret) {
-                    logging.error("Requestor::send 发送请求失败");
+                    LOG_ERROR("Requestor::send 发送请求失败");
                     return false;
                 }
                 _rsp = async_rsp.get();
@@ -61,7 +62,7 @@ namespace rpc {
             bool async_send(const BaseConnection::ptr& _conn, const BaseMessage::ptr& _req, AsyncResponse& _async_rsp) {
                 RequestDescribe::ptr desc = new_describe(_req, RpcType::ASYNC);
                 if (!desc) {
-                    logging.error("Requestor::send 创建请求描述失败");
+                    LOG_ERROR("Requestor::send 创建请求描述失败");
                     return false;
                 }
                 _conn->send(_req);
@@ -72,13 +73,30 @@ namespace rpc {
             bool callback_send(const BaseConnection::ptr& _conn, const BaseMessage::ptr& _req, const RequestCallBack& _cb) {
                 RequestDescribe::ptr desc = new_describe(_req, RpcType::CALLBACK, _cb);
                 if (!desc) {
-                    logging.error("Requestor::send 创建请求描述失败");
+                    LOG_ERROR("Requestor::send 创建请求描述失败");
                     return false;
                 }
                 _conn->send(_req);
                 return true;
             }
         private:
+            // 按方法名调用成功时服务端会告知编号, 之后同一连接上的调用只发送编号
+            // 在交给调用者之前记下, 同步调用返回后的下一次调用就能用上; 旧版本的服务端不会告知, 之后继续按方法名调用
+            void learn_method_id(const BaseConnection::ptr& _conn, const BaseMessage::ptr& _req, const BaseMessage::ptr& _rsp) {
+                if (_rsp->get_type() != MsgType::RSP_RPC) {
+                    return;
+                }
+                RpcResponse::ptr rsp = std::dynamic_pointer_cast<RpcResponse>(_rsp);
+                RpcRequest::ptr req = std::dynamic_pointer_cast<RpcRequest>(_req);
+                if (!rsp || !req) {
+                    return;
+                }
+                uint32_t method_id = rsp->get_method_id();
+                if (method_id != 0) {
+                    _conn->learn_method_id(req->get_method(), method_id);
+                }
+            }
+
             RequestDescribe::ptr new_describe(const BaseMessage::ptr& _req, RpcType _type, const RequestCallBack& _cb = nullptr) {
                 std::lock_guard<std::mutex> lock(mtx);
                 RequestDescribe::ptr desc = std::make_shared<RequestDescribe>();
@@ -91,7 +109,7 @@ namespace rpc {
                 return desc;
             }
 
-            RequestDescribe::ptr get_describe(const std::string& _req_id) {
+            RequestDescribe::ptr get_describe(uint64_t _req_id) {
                 std::lock_guard<std::mutex> lock(mtx);
                 auto it = requset_desc.find(_req_id);
                 if (it != requset_desc.end()) {
@@ -100,13 +118,13 @@ namespace rpc {
                 return nullptr;
             }
 
-            void remove_describe(const std::string& _req_id) {
+            void remove_describe(uint64_t _req_id) {
                 std::lock_guard<std::mutex> lock(mtx);
                 requset_desc.erase(_req_id);
             }
         private:
             std::mutex mtx;
-            std::unordered_map<std::string, RequestDescribe::ptr> requset_desc;
+            std::unordered_map<uint64_t, RequestDescribe::ptr> requset_desc;
         };
     }
 }
\ No newline at end of file
@@ -17,28 +17,24 @@ namespace rpc {
             // 同步调用
             bool sync_call(const BaseConnection::ptr& _conn, const std::string& _method, const std::vector<PBValue>& _params, PBValue& _result) {
                 // 组织请求数据
-                RpcRequest::ptr req = MessageFactory::create<RpcRequest>();
-                req->set_id(UUID::ramdom());
-                req->set_type(MsgType::REQ_RPC);
-                req->set_method(_method);
-                req->set_params(_params);
+                RpcRequest::ptr req = create_request(_conn, _method, _params);
                 // 发送请求
                 BaseMessage::ptr base_rsp;
                 bool ret = requestor->sync_send(_conn, req, base_rsp);
                 if(!ret) {
-                    logging.error("RpcCaller::call 发送请求失败");
+                    LOG_ERROR("RpcCaller::call 发送请求失败");
                     return false;
                 }
                 // 等待响应
                 RpcResponse::ptr rsp = std::dynamic_pointer_cast<RpcResponse>(base_rsp);
                 if(!rsp) {
-                    logging.error("RpcCaller::call 响应类型错误");
+                    LOG_ERROR("RpcCaller::call 响应类型错误");
                     return false;
                 }
                 _result = rsp->get_result();
 
                 if(rsp->get_retcode() != RetCode::SUCCESS) {
-                    logging.error("RpcCaller::call 请求失败, 错误码:{}", err_reason(rsp->get_retcode()));
+                    LOG_ERROR("RpcCaller::call 请求失败, 错误码:{}", err_reason(rsp->get_retcode()));
                     return false;
                 }
                 return true;
@@ -46,18 +42,14 @@ namespace rpc {
 
             //异步调用
             bool async_call(const BaseConnection::ptr& _conn, const std::string& _method, const std::vector<PBValue>& _params, PBAsyncResponse& _result) {
-                RpcRequest::ptr req = MessageFactory::create<RpcRequest>();
-                req->set_id(UUID::ramdom());
-                req->set_type(MsgType::REQ_RPC);
-                req->set_method(_method);
-                req->set_params(_params);
+                RpcRequest::ptr req = create_request(_conn, _method, _params);
                 // 发送请求
                 auto pb_promise = std::make_shared<std::promise<PBValue>>();
                 _result = pb_promise->get_future();
                 Requestor::RequestCallBack callback = std::bind(&RpcCaller::async_callback, this, std::placeholders::_1, pb_promise);
                 bool ret = requestor->callback_send(_conn, req, callback);
                 if(!ret) {
-                    logging.error("RpcCaller::call 发送请求失败");
+                    LOG_ERROR("RpcCaller::call 发送请求失败");
                     return false;
                 }
                 return true;
@@ -66,28 +58,40 @@ namespace rpc {
             // 回调
             bool callback_call(const BaseConnection::ptr& _conn, const std::string& _method, const std::vector<PBValue>& _params, const PBResponseCallback& _cb) {
                 // 组织请求数据
-                RpcRequest::ptr req = MessageFactory::create<RpcRequest>();
-                req->set_id(UUID::ramdom());
-                req->set_type(MsgType::REQ_RPC);
-                req->set_method(_method);
-                req->set_params(_params);
+                RpcRequest::ptr req = create_request(_conn, _method, _params);
                 Requestor::RequestCallBack callback = std::bind(&RpcCaller::callback, this, std::placeholders::_1, _cb);
                 bool ret = requestor->callback_send(_conn, req, callback);
                 if(!ret) {
-                    logging.error("RpcCaller::call 发送请求失败");
+                    LOG_ERROR("RpcCaller::call 发送请求失败");
                     return false;
                 }
                 return true;
             }
         private:
+            // 已经知道该连接上的方法编号时只发送编号, 否则发送方法名
+            RpcRequest::ptr create_request(const BaseConnection::ptr& _conn, const std::string& _method, const std::vector<PBValue>& _params) {
+                RpcRequest::ptr req = MessageFactory::create<RpcRequest>();
+                req->set_id(UUID::next_id());
+                req->set_type(MsgType::REQ_RPC);
+                uint32_t method_id = _conn->find_method_id(_method);
+                if (method_id != 0) {
+                    req->set_method_id(method_id);
+                }
+                else {
+                    req->set_method(_method);
+                }
+                req->set_params(_params);
+                return req;
+            }
+
             void async_callback(const BaseMessage::ptr& _msg, std::shared_ptr<std::promise<PBValue>>& _result) {
                 RpcResponse::ptr rsp = std::dynamic_pointer_cast<RpcResponse>(_msg);
                 if(!rsp) {
-                    logging.error("RpcCaller::callback 响应类型错误");
+                    LOG_ERROR("RpcCaller::callback 响应类型错误");
                     return;
                 }
                 if(rsp->get_retcode() != RetCode::SUCCESS) {
-                    logging.error("RpcCaller::callback 请求失败, 错误码:{}", err_reason(rsp->get_retcode()));
+                    LOG_ERROR("RpcCaller::callback 请求失败, 错误码:{}", err_reason(rsp->get_retcode()));
                     return;
                 }
                 _result->set_value(rsp->get_result());
@@ -96,11 +100,11 @@ namespace rpc {
             void callback(const BaseMessage::ptr& _msg, const PBResponseCallback& _cb) {
                 RpcResponse::ptr rsp = std::dynamic_pointer_cast<RpcResponse>(_msg);
                 if(!rsp) {
-                    logging.error("RpcCaller::callback 响应类型错误");
+                    LOG_ERROR("RpcCaller::callback 响应类型错误");
                     return;
                 }
                 if(rsp->get_retcode() != RetCode::SUCCESS) {
-                    logging.error("RpcCaller::callback 请求失败, 错误码:{}", err_reason(rsp->get_retcode()));
+                    LOG_ERROR("RpcCaller::callback 请求失败, 错误码:{}", err_reason(rsp->get_retcode()));
                     return;
                 }
                 _cb(rsp->get_result());
@@ -100,17 +100,17 @@ namespace rpc {
             bool sync_call(const std::string& method, const std::vector<PBValue>& param, PBValue& result) {
                 BaseClient::ptr client = get_client(method);
                 if(!client) {
-                    logging.error("RpcClient::sync_call 获取客户端失败, method: %s", method.c_str());
+                    LOG_ERROR("RpcClient::sync_call 获取客户端失败, method: %s", method.c_str());
                     return false;
                 }
-                logging.debug("RpcClient::sync_call 获取客户端成功, method: %s", method.c_str());
+                LOG_DEBUG("RpcClient::sync_call 获取客户端成功, method: %s", method.c_str());
                 return caller->sync_call(client->get_connection(), method, param, result);
             }
 
             bool async_call(const std::string& method, const std::vector<PBValue>& param, RpcCaller::PBAsyncResponse& result) {
                 BaseClient::ptr client = get_client(method);
                 if(!client) {
-                    logging.error("RpcClient::async_call 获取客户端失败, method: %s", method.c_str());
+                    LOG_ERROR("RpcClient::async_call 获取客户端失败, method: %s", method.c_str());
                     return false;
                 }
                 return caller->async_call(client->get_connection(), method, param, result);
@@ -119,7 +119,7 @@ namespace rpc {
             bool callback_call(const std::string& method, const std::vector<PBValue>& param, const RpcCaller::PBResponseCallback& cb) {
                 BaseClient::ptr client = get_client(method);
                 if(!client) {
-                    logging.error("RpcClient::callback_call 获取客户端失败, method: %s", method.c_str());
+                    LOG_ERROR("RpcClient::callback_call 获取客户端失败, method: %s", method.c_str());
                     return false;
                 }
                 return caller->callback_call(client->get_connection(), method, param, cb);
@@ -130,7 +130,7 @@ namespace rpc {
                 // 创建一个新的基础客户端
                 BaseClient::ptr client = ClientFactory::create(host.first, host.second);
                 if(!client) {
-                    logging.error("RpcClient::create_client 创建客户端失败, host: {}", host.first);
+                    LOG_ERROR("RpcClient::create_client 创建客户端失败, host: {}", host.first);
                     return BaseClient::ptr();
                 }
                 auto msg_cb = std::bind(&Dispatcher::on_message, dispatcher, std::placeholders::_1, std::placeholders::_2);
@@ -161,7 +161,7 @@ namespace rpc {
                         }
                     }
                     else {
-                        logging.error("RpcClient::get_client 服务发现失败, 没有找到服务提供者, method: %s", method.c_str());
+                        LOG_ERROR("RpcClient::get_client 服务发现失败, 没有找到服务提供者, method: %s", method.c_str());
                         return BaseClient::ptr();
                     }
                 }
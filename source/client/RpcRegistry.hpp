@@ -14,24 +14,24 @@ namespace rpc {
             // 注册服务
             bool registry_method(const BaseConnection::ptr& _connection, const std::string& _method, const Address& _host) {
                 auto msg_req = MessageFactory::create<ServiceRequest>();
-                msg_req->set_id(UUID::ramdom());
+                msg_req->set_id(UUID::next_id());
                 msg_req->set_type(MsgType::REQ_SERVICE);
                 msg_req->set_method(_method);
                 msg_req->set_address(_host);
                 msg_req->set_optype(ServiceOptype::REGISTRY);
                 BaseMessage::ptr base_rsp;
-                logging.debug("Provider::registry_method 发送请求: %s", msg_req->get_method().c_str());
+                LOG_DEBUG("Provider::registry_method 发送请求: %s", msg_req->get_method().c_str());
                 if(!requestor->sync_send(_connection, msg_req, base_rsp)) {
-                    logging.error("Provider::registry_method 发送请求失败");
+                    LOG_ERROR("Provider::registry_method 发送请求失败");
                     return false;
                 }
                 auto msg_rsp = std::dynamic_pointer_cast<ServiceResponse>(base_rsp);
                 if(!msg_rsp) {
-                    logging.error("Provider::registry_method 接收响应失败");
+                    LOG_ERROR("Provider::registry_method 接收响应失败");
                     return false;
                 }
                 if(msg_rsp->get_retcode() != RetCode::SUCCESS) {
-                    logging.error("Provider::registry_method 注册失败, %s", err_reason(msg_rsp->get_retcode()).c_str());
+                    LOG_ERROR("Provider::registry_method 注册失败, %s", err_reason(msg_rsp->get_retcode()).c_str());
                     return false;
                 }
                 return true;
@@ -69,11 +69,22 @@ namespace rpc {
                 }
             }
 
-            // 获取下一个host
-            Address get_host() {
+            // 轮询获取下一个host
+            // 同一台机器上的提供者通告了共享内存或unix套接字地址时优先使用, 其他机器的这类地址无法连接, 跳过
+            bool get_host(Address& _host) {
                 std::lock_guard<std::mutex> lock(mtx);
-                size_t pos = index++ % hosts.size();
-                return hosts[pos];
+                size_t count = hosts.size();
+                for (int rank = 2; rank >= 0; rank--) {
+                    for (size_t i = 0; i < count; i++) {
+                        const Address& host = hosts[(index + i) % count];
+                        if (host_rank(host) == rank) {
+                            index += i + 1;
+                            _host = host;
+                            return true;
+                        }
+                    }
+                }
+                return false;
             }
 
             // 判断是否为空
@@ -82,6 +93,17 @@ namespace rpc {
                 return hosts.empty();
             }
         private:
+            // 本机共享内存为2, 本机unix套接字为1, 网络地址为0, 其他机器的本地地址不可用
+            static int host_rank(const Address& _host) {
+                if (!is_local_transport(_host)) {
+                    return 0;
+                }
+                if (!is_local_address(_host)) {
+                    return -1;
+                }
+                return _host.first.compare(0, 4, "shm:") == 0 ? 2 : 1;
+            }
+
             std::mutex mtx;
             size_t index;
             std::vector<Address> hosts;
@@ -102,38 +124,36 @@ namespace rpc {
                     // 先从缓存中查找
                     std::lock_guard<std::mutex> lock(mtx);
                     auto it = method_hosts.find(_method);
-                    if(it != method_hosts.end() && !it->second->empty()) {
-                        _host = it->second->get_host();
+                    if(it != method_hosts.end() && it->second->get_host(_host)) {
                         return true;
                     }
                 }
                 // 当前没有可用的host
                 auto msg_req = MessageFactory::create<ServiceRequest>();
-                msg_req->set_id(UUID::ramdom());
+                msg_req->set_id(UUID::next_id());
                 msg_req->set_type(MsgType::REQ_SERVICE);
                 msg_req->set_method(_method);
                 msg_req->set_optype(ServiceOptype::DISCOVERY);
                 BaseMessage::ptr base_rsp;
                 if(!requestor->sync_send(_connection, msg_req, base_rsp)) {
-                    logging.error("Discoverer::service_discovery 发送请求失败");
+                    LOG_ERROR("Discoverer::service_discovery 发送请求失败");
                     return false;
                 }
                 auto msg_rsp = std::dynamic_pointer_cast<ServiceResponse>(base_rsp);
                 if(!msg_rsp) {
-                    logging.error("Discoverer::service_discovery 接收响应失败");
+                    LOG_ERROR("Discoverer::service_discovery 接收响应失败");
                     return false;
                 }
                 if(msg_rsp->get_retcode() != RetCode::SUCCESS) {
-                    logging.error("Discoverer::service_discovery 发现服务失败, %s", err_reason(msg_rsp->get_retcode()).c_str());
+                    LOG_ERROR("Discoverer::service_discovery 发现服务失败, %s", err_reason(msg_rsp->get_retcode()).c_str());
                     return false;
                 }
                 std::lock_guard<std::mutex> lock(mtx);
                 auto method_host = std::make_shared<MethodHost>(msg_rsp->get_address());
-                if(method_host->empty()) {
-                    logging.error("Discoverer::service_discovery 发现服务失败, 没有可用的host");
+                if(!method_host->get_host(_host)) {
+                    LOG_ERROR("Discoverer::service_discovery 发现服务失败, 没有可用的host");
                     return false;
                 }
-                _host = method_host->get_host();
                 method_hosts[_method] = method_host;
                 return true;
             }
@@ -141,7 +161,7 @@ namespace rpc {
             void on_service_request(const BaseConnection::ptr& _connection, const ServiceRequest::ptr& _req) {
                 // 先检查请求是否合法
                 if (!_req->check()) {
-                    logging.error("Discoverer::on_service_request 请求格式错误: %s", _req->get_method().c_str());
+                    LOG_ERROR("Discoverer::on_service_request 请求格式错误: %s", _req->get_method().c_str());
                     return;
                 }
                 std::unique_lock<std::mutex> lock(mtx);
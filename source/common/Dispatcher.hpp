@@ -38,7 +38,7 @@ namespace rpc {
         void register_handler(MsgType type, const typename CallBack<PBMessage>::MessageCallBack& handler) {
             std::lock_guard<std::mutex> lock(mtx);
             auto cb = std::make_shared<CallBack<PBMessage>>(handler);
-            logging.debug("Dispatcher::register_handler: 注册消息处理函数, msg_type: %d", type);
+            LOG_DEBUG("Dispatcher::register_handler: 注册消息处理函数, msg_type: %d", type);
             handlers[type] = cb;
         }
 
@@ -46,7 +46,7 @@ namespace rpc {
             std::lock_guard<std::mutex> lock(mtx);
             auto it = handlers.find(msg->get_type());
             if (it == handlers.end()) {
-                logging.fatal("Dispatcher::on_message: 没有对应的处理函数, msg_type: %d", msg->get_type());
+                LOG_FATAL("Dispatcher::on_message: 没有对应的处理函数, msg_type: %d", msg->get_type());
                 conn->shutdown();
                 return;
             }
@@ -6,6 +6,7 @@ namespace rpc
 {
     namespace key {
         const std::string method = "method";
+        const std::string method_id = "method_id";
         const std::string params = "params";
         const std::string topic = "topic";
         const std::string message = "message";
@@ -17,6 +18,12 @@ namespace rpc
         const std::string result = "result";
     }
 
+    // LVProtocol 的帧格式版本
+    enum class WireVersion {
+        V1 = 1, // |Length|MsgType|IDLength|ID|Data|, ID 为任意字符串
+        V2 = 2, // |Length|Version|MsgType|ID|Data|, Version 占类型字段的高8位, ID 为定长的8字节整数
+    };
+
     enum class MsgType {
         REQ_RPC = 0, //请求RPC
         RSP_RPC = 1, //响应RPC
@@ -36,6 +43,7 @@ namespace rpc
         NOT_FOUND_TOPIC = 6, //未找到主题
         INTERNAL_ERROR = 7, //内部错误
         INVALID_OPTYPE = 8, //无效操作类型
+        OVERLOADED = 9, //对端积压过多, 请求被丢弃
     };
 
     static std::string err_reason(RetCode code) {
@@ -49,6 +57,7 @@ namespace rpc
             {RetCode::NOT_FOUND_TOPIC, "未找到主题"},
             {RetCode::INTERNAL_ERROR, "内部错误"},
             {RetCode::INVALID_OPTYPE, "无效操作类型"},
+            {RetCode::OVERLOADED, "响应积压过多, 请求被丢弃"},
         };
         auto it = err_map.find(code);
         if (it != err_map.end()) {
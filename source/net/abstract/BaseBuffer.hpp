@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <algorithm>
 
 namespace rpc
 {
@@ -9,10 +10,42 @@ namespace rpc
     public:
         using ptr = std::shared_ptr<BaseBuffer>;
 
+        //一段连续的可读数据
+        struct Span
+        {
+            const char* data;
+            size_t len;
+        };
+
         virtual size_t read_able_size() = 0;
         virtual int32_t peek_int32() = 0;
         virtual void retrieve_int32(int32_t& _data) = 0;
         virtual int32_t read_int32() = 0;
         virtual std::string retrieve_as_string(size_t len) = 0;
+        //丢弃前 len 字节的可读数据
+        virtual void move_read(size_t len) = 0;
+        //可读数据所在的连续区间, 返回段数(0~2), 底层为环形缓冲区且数据绕回时为两段
+        virtual int peek_spans(Span* spans) = 0;
+
+        //可读数据中从 offset 开始长为 len 的只读视图, 不拷贝数据, 返回段数(0~2)
+        //视图指向缓冲区内部, 只在下一次 move_read 之前有效, 调用者保证数据足够
+        int read_view(size_t offset, size_t len, Span* view) {
+            Span spans[2];
+            int count = peek_spans(spans);
+            int n = 0;
+            for (int i = 0; i < count && len > 0; i++) {
+                if (offset >= spans[i].len) {
+                    offset -= spans[i].len;
+                    continue;
+                }
+                size_t take = std::min(len, spans[i].len - offset);
+                view[n].data = spans[i].data + offset;
+                view[n].len = take;
+                n++;
+                offset = 0;
+                len -= take;
+            }
+            return n;
+        }
     };
 }
\ No newline at end of file
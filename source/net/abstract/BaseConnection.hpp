@@ -1,15 +1,77 @@
 #pragma once
 #include "BaseMessage.hpp"
+#include <functional>
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace rpc
 {
     class BaseConnection
     {
+    protected:
+        // 发给对端的帧格式, 收到 V1 的帧后降级为 V1, 旧版本的对端可以继续使用
+        std::atomic<WireVersion> wire_version{ WireVersion::V2 };
+
+    private:
+        using MethodIds = std::unordered_map<std::string, uint32_t>;
+        // 对端告知的方法编号, 只由连接所在的loop线程写入, 调用线程不加锁读取当前快照
+        // 写入时复制出新的快照, 旧快照保留到连接释放, 正在读的线程不会读到已经释放的表
+        std::atomic<const MethodIds*> method_ids{ nullptr };
+        std::vector<std::unique_ptr<const MethodIds>> method_id_snapshots;
     public:
         using ptr = std::shared_ptr<BaseConnection>;
+        // 第二个参数为触发时发送缓冲区中积压的字节数
+        using WaterMarkCallBack = std::function<void(const BaseConnection::ptr& conn, size_t pending)>;
 
         virtual void send(const BaseMessage::ptr& msg) = 0;
         virtual void shutdown() = 0;
         virtual bool is_connected() = 0;
+
+        // 发送缓冲区积压到 high 字节时调用 high_cb, 之后回落到 low 字节以下时调用 low_cb
+        // 需在连接回调中设置
+        virtual void set_water_mark(size_t high, size_t low, const WaterMarkCallBack& high_cb, const WaterMarkCallBack& low_cb) = 0;
+        // 发送缓冲区是否处于高水位, 上层可以据此丢弃发给该对端的非必要消息
+        virtual bool is_congested() = 0;
+        // 暂停/恢复读取对端的请求
+        virtual void pause_read() = 0;
+        virtual void resume_read() = 0;
+
+        WireVersion get_wire_version() const {
+            return wire_version.load(std::memory_order_relaxed);
+        }
+
+        // 该连接上方法的编号, 还不知道时返回 0
+        uint32_t find_method_id(const std::string& method) const {
+            const MethodIds* ids = method_ids.load(std::memory_order_acquire);
+            if (ids == nullptr) {
+                return 0;
+            }
+            auto it = ids->find(method);
+            return it != ids->end() ? it->second : 0;
+        }
+
+        // 记下对端告知的方法编号, 只能在连接所在的loop线程中调用
+        void learn_method_id(const std::string& method, uint32_t method_id) {
+            const MethodIds* ids = method_ids.load(std::memory_order_relaxed);
+            if (ids != nullptr) {
+                auto it = ids->find(method);
+                if (it != ids->end() && it->second == method_id) {
+                    return;
+                }
+            }
+            std::unique_ptr<MethodIds> snapshot(ids != nullptr ? new MethodIds(*ids) : new MethodIds());
+            (*snapshot)[method] = method_id;
+            method_ids.store(snapshot.get(), std::memory_order_release);
+            method_id_snapshots.emplace_back(std::move(snapshot));
+        }
+
+        // 收到消息后调用, 对端发来 V1 的帧时之后的消息也使用 V1
+        void on_peer_message(const BaseMessage::ptr& msg) {
+            if (msg->is_legacy() && get_wire_version() != WireVersion::V1) {
+                wire_version.store(WireVersion::V1, std::memory_order_relaxed);
+            }
+        }
     };
 }
\ No newline at end of file
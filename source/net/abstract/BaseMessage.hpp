@@ -1,6 +1,8 @@
 #pragma once
 #include "../../common/Fields.hpp"
+#include "BaseBuffer.hpp"
 #include <memory>
+#include <cstring>
 
 namespace rpc
 {
@@ -8,20 +10,43 @@ namespace rpc
     {
     protected:
         rpc::MsgType type;
-        std::string id;
+        uint64_t id = 0;
+        // 来自 V1 对端的消息, 其 ID 是任意字符串, 回复时需要原样带回
+        bool legacy = false;
+        std::string legacy_id;
     public:
         using ptr = std::shared_ptr<BaseMessage>;
 
         virtual ~BaseMessage() {}
 
-        virtual std::string get_id() const {
+        virtual uint64_t get_id() const {
             return id;
         }
 
-        virtual void set_id(const std::string& id_) {
+        virtual void set_id(uint64_t id_) {
             id = id_;
         }
 
+        bool is_legacy() const {
+            return legacy;
+        }
+
+        const std::string& get_legacy_id() const {
+            return legacy_id;
+        }
+
+        void set_legacy_id(const std::string& id_) {
+            legacy = true;
+            legacy_id = id_;
+        }
+
+        // 回复 _req 时使用与其相同的 ID
+        void set_id_from(const BaseMessage& _req) {
+            id = _req.id;
+            legacy = _req.legacy;
+            legacy_id = _req.legacy_id;
+        }
+
         virtual rpc::MsgType get_type() const {
             return type;
         }
@@ -32,5 +57,23 @@ namespace rpc
 
         virtual std::string serialize() = 0;
         virtual bool deserialize(const std::string& msg) = 0;
+        //序列化后的字节数, 随后的 serialize_to 按这个大小写入, 两次调用之间不能修改消息
+        virtual size_t byte_size() {
+            return serialize().size();
+        }
+        //序列化到调用者准备好的 byte_size() 字节的空间中, 返回写入数据的末尾, 失败时返回 nullptr
+        virtual char* serialize_to(char* out) {
+            std::string msg = serialize();
+            memcpy(out, msg.data(), msg.size());
+            return out + msg.size();
+        }
+        //直接从缓冲区的只读视图反序列化, 默认先拼接成字符串
+        virtual bool deserialize(const BaseBuffer::Span* view, int count) {
+            std::string msg;
+            for (int i = 0; i < count; i++) {
+                msg.append(view[i].data, view[i].len);
+            }
+            return deserialize(msg);
+        }
     };
 }
\ No newline at end of file
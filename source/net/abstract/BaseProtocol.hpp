@@ -11,6 +11,6 @@ namespace rpc
 
         virtual bool can_process(const BaseBuffer::ptr& buffer) = 0;
         virtual bool on_message(const BaseBuffer::ptr& buffer, BaseMessage::ptr& msg) = 0;
-        virtual std::string serialize(const BaseMessage::ptr& msg) = 0;
+        virtual std::string serialize(const BaseMessage::ptr& msg, WireVersion version) = 0;
     };
 }
\ No newline at end of file
@@ -29,6 +29,12 @@ namespace rpc
             msg_cb = cb;
         }
         
+        // 不小于 threshold 字节的消息以零拷贝方式发送, 不支持的传输方式忽略
+        virtual void enable_zerocopy(size_t /*threshold*/) {}
+
+        // 额外监听一个地址, ip 写作 "unix:<路径>" 时为本机 unix 套接字, 需在 start 之前调用
+        virtual void add_listen(int port, const std::string& ip) = 0;
+
         virtual void start() = 0;
     };
 }
\ No newline at end of file
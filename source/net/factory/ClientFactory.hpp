@@ -1,13 +1,17 @@
 #pragma once
 #include "../abstract/BaseClient.hpp"
 #include "../package/MuduoClient.hpp"
+#include "../package/ShmClient.hpp"
 
 namespace rpc {
     class ClientFactory {
     public:
-        template<typename ...Args>
-        static BaseClient::ptr create(Args &&...args) {
-            return std::make_shared<MuduoClient>(std::forward<Args>(args)...);
+        // ip 写作 "shm:<路径>" 时使用本机共享内存传输, 其他地址(TCP/unix套接字)使用 MuduoClient
+        static BaseClient::ptr create(const std::string& ip, int port) {
+            if (ShmServer::is_shm_address(ip)) {
+                return std::make_shared<ShmClient>(ip);
+            }
+            return std::make_shared<MuduoClient>(ip, port);
         }
     };
 }
\ No newline at end of file
@@ -1,13 +1,17 @@
 #pragma once
 
 #include "../package/MuduoServer.hpp"
+#include "../package/ShmServer.hpp"
 
 namespace rpc {
     class ServerFactory {
     public:
-        template<typename ...Args>
-        static BaseServer::ptr create(Args &&...args) {
-            return std::make_shared<MuduoServer>(std::forward<Args>(args)...);
+        // ip 写作 "shm:<路径>" 时使用本机共享内存传输, 其他地址(TCP/unix套接字)使用 MuduoServer
+        static BaseServer::ptr create(int port, const std::string& ip) {
+            if (ShmServer::is_shm_address(ip)) {
+                return std::make_shared<ShmServer>(ip);
+            }
+            return std::make_shared<MuduoServer>(port, ip);
         }
     };
 }
\ No newline at end of file
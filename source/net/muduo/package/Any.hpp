@@ -62,7 +62,7 @@ namespace muduo
             typeid(T);
             content->type();
             if (typeid(T) != content->type()) {
-                logging.fatal("Any类型不匹配!");
+                LOG_FATAL("Any类型不匹配!");
                 return nullptr;
             }
             else {
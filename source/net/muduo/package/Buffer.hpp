@@ -4,21 +4,56 @@
 #include <vector>
 #include <algorithm>
 #include <cassert>
+#include <sys/uio.h>
 #include "../../../util/Log.hpp"
+#include "BufferPool.hpp"
 
 namespace muduo
 {
+    //存储空间按需分配: 构造时不分配, 第一次写入时才申请
+    //指定了 BufferPool 时, 不超过一块大小的存储从池中借用, 数据被取空后立即归还(或释放), 空闲时不占内存
+    //没有指定 BufferPool 时, 存储从堆上分配, 取空后保留以便复用
+    //两种存储布局:
+    //LINEAR 线性模式, 可读数据总是连续的, 尾部空间不足时把未读数据前移
+    //RING 环形模式, 容量为2的幂, 读写下标只增不减, 取模得到位置, 不再前移数据
+    //       可读/可写区间在绕回时分成两段, 需要通过 peek_spans/write_spans 访问
     class Buffer
     {
+    public:
+        enum Mode {
+            LINEAR,
+            RING,
+        };
+
     private:
-        static const size_t default_buffer_size = 65536;
+        static constexpr size_t default_buffer_size = 65536;
 
-        std::vector<char> buffer;
-        size_t read_idx; //读偏移
-        size_t write_idx; //写偏移
+        char* storage; //存储空间, 为空表示尚未分配
+        size_t capacity; //存储空间的大小
+        BufferPool* pool; //借用存储的池, 可以为空
+        bool pooled; //storage 是否借自 pool
+        Mode mode; //存储布局
+        size_t read_idx; //读偏移, 环形模式下为累计读取的字节数
+        size_t write_idx; //写偏移, 环形模式下为累计写入的字节数
     private:
         char* begin() {
-            return &*buffer.begin();
+            return storage;
+        }
+
+        static size_t round_up_pow2(size_t _len) {
+            size_t ret = 1;
+            while (ret < _len) {
+                ret <<= 1;
+            }
+            return ret;
+        }
+
+        size_t read_pos() {
+            return mode == RING ? (read_idx & (capacity - 1)) : read_idx;
+        }
+
+        size_t write_pos() {
+            return mode == RING ? (write_idx & (capacity - 1)) : write_idx;
         }
 
         size_t head_space() {
@@ -26,14 +61,72 @@ namespace muduo
         }
 
         size_t tail_space() {
-            return buffer.size() - write_idx;
+            return capacity - write_idx;
+        }
+
+        //总的可写空间, 环形模式下包括绕回到头部的部分
+        size_t free_space() {
+            return mode == RING ? capacity - read_able_size() : tail_space();
+        }
+
+        void allocate(size_t _len) {
+            if (pool != nullptr && _len <= BufferPool::chunk_size) {
+                storage = pool->acquire();
+                capacity = BufferPool::chunk_size;
+                pooled = true;
+            }
+            else {
+                capacity = std::max(_len, default_buffer_size);
+                if (mode == RING) {
+                    capacity = round_up_pow2(capacity);
+                }
+                storage = new char[capacity];
+                pooled = false;
+            }
+        }
+
+        void free_storage() {
+            if (storage == nullptr) {
+                return;
+            }
+            if (pooled) {
+                pool->release(storage);
+            }
+            else {
+                delete[] storage;
+            }
+            storage = nullptr;
+            capacity = 0;
+            pooled = false;
+        }
+
+        //扩容, 按倍数增长, 只搬移未读的数据; 超出一块大小后不再使用池中的块
+        //新空间不做零初始化
+        void grow(size_t _len) {
+            size_t read_size = read_able_size();
+            size_t new_capacity = std::max(read_size + _len, capacity * 2);
+            if (mode == RING) {
+                new_capacity = round_up_pow2(new_capacity);
+            }
+            LOG_DEBUG("buffer 扩容至: %d 字节", new_capacity);
+            char* new_storage = new char[new_capacity];
+            peek(new_storage, read_size);
+            free_storage();
+            storage = new_storage;
+            capacity = new_capacity;
+            read_idx = 0;
+            write_idx = read_size;
         }
 
         void write_check(size_t _len) {
-            if (tail_space() >= _len) {
+            if (storage == nullptr) {
+                allocate(_len);
+                return;
+            }
+            if (free_space() >= _len) {
                 return;
             }
-            else if (head_space() + tail_space() >= _len) {
+            else if (mode == LINEAR && head_space() + tail_space() >= _len) {
                 //数据前移
                 size_t read_size = read_able_size();
                 std::copy(get_read_idx(), get_read_idx() + read_size, begin());
@@ -41,39 +134,72 @@ namespace muduo
                 write_idx = read_size;
             }
             else {
-                //扩容
-                logging.debug("buffer 扩容至: %d 字节", write_idx + _len);
-                buffer.resize(write_idx + _len);
+                grow(_len);
             }
         }
     public:
 
-        Buffer()
-            : buffer(default_buffer_size), read_idx(0), write_idx(0) {}
+        Buffer(BufferPool* _pool = nullptr, Mode _mode = LINEAR)
+            : storage(nullptr), capacity(0), pool(_pool), pooled(false), mode(_mode), read_idx(0), write_idx(0) {}
+
+        //析构可能发生在loop线程之外, 借用的块直接释放而不归还, 使用者应在loop中先调用 clear
+        ~Buffer() {
+            delete[] storage;
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
 
+        Mode get_mode() {
+            return mode;
+        }
+
+        //只能在缓冲区为空时切换
+        void set_mode(Mode _mode) {
+            if (read_able_size() != 0) {
+                LOG_ERROR("缓冲区非空, 不能切换存储布局!");
+                return;
+            }
+            if (mode != _mode) {
+                free_storage();
+                read_idx = write_idx = 0;
+                mode = _mode;
+            }
+        }
+
+        //保证至少有 _len 字节可写, 供 readv 等直接写入 write_spans 的场景使用
+        void reserve(size_t _len) {
+            write_check(_len);
+        }
+
+        //可读数据的起始位置, 环形模式下只是第一段的起始位置
         char* get_read_idx() {
-            return begin() + read_idx;
+            return begin() + read_pos();
         }
 
         char* get_write_idx() {
-            return begin() + write_idx;
+            return begin() + write_pos();
         }
 
         void move_write(size_t _len) {
-            if (_len <= tail_space()) {
+            if (_len <= free_space()) {
                 write_idx += _len;
             }
             else {
-                logging.error("缓冲区读取下标移动错误!");
+                LOG_ERROR("缓冲区读取下标移动错误!");
             }
         }
 
         void move_read(size_t _len) {
             if (_len <= read_able_size()) {
                 read_idx += _len;
+                //数据被取空时归位, 让尾部重新获得完整的可写空间, 避免之后的数据前移
+                if (read_idx == write_idx) {
+                    clear();
+                }
             }
             else {
-                logging.error("缓冲区写入下标移动错误!");
+                LOG_ERROR("缓冲区写入下标移动错误!");
             }
         }
 
@@ -81,19 +207,85 @@ namespace muduo
             return write_idx - read_idx;
         }
 
+        //从 get_write_idx() 开始可连续写入的空间
+        size_t write_able_size() {
+            if (mode == RING) {
+                return std::min(free_space(), capacity - write_pos());
+            }
+            return tail_space();
+        }
+
+        //可读数据所在的区间, 返回段数(0~2), 线性模式下最多一段
+        int peek_spans(struct iovec* _vec) {
+            size_t read_size = read_able_size();
+            if (read_size == 0) {
+                return 0;
+            }
+            size_t first = mode == RING ? std::min(read_size, capacity - read_pos()) : read_size;
+            _vec[0].iov_base = get_read_idx();
+            _vec[0].iov_len = first;
+            if (first == read_size) {
+                return 1;
+            }
+            _vec[1].iov_base = begin();
+            _vec[1].iov_len = read_size - first;
+            return 2;
+        }
+
+        //可写空间所在的区间, 返回段数(0~2), 线性模式下最多一段, 供 readv 直接读入
+        int write_spans(struct iovec* _vec) {
+            size_t write_size = free_space();
+            if (write_size == 0) {
+                return 0;
+            }
+            size_t first = write_able_size();
+            _vec[0].iov_base = get_write_idx();
+            _vec[0].iov_len = first;
+            if (first == write_size) {
+                return 1;
+            }
+            _vec[1].iov_base = begin();
+            _vec[1].iov_len = write_size - first;
+            return 2;
+        }
+
+        //拷贝出开头的 _len 字节, 不移动读偏移
+        void peek(char* _buffer, size_t _len) {
+            struct iovec vec[2];
+            int count = peek_spans(vec);
+            for (int i = 0; i < count && _len > 0; i++) {
+                size_t len = std::min(_len, vec[i].iov_len);
+                const char* src = static_cast<const char*>(vec[i].iov_base);
+                std::copy(src, src + len, _buffer);
+                _buffer += len;
+                _len -= len;
+            }
+        }
+
         void read(char* _buffer, size_t _len) {
             if (_len <= read_able_size()) {
-                std::copy(get_read_idx(), get_read_idx() + _len, _buffer);
+                peek(_buffer, _len);
                 move_read(_len);
             }
             else {
-                logging.warning("读取数据大于可读空间大小!");
+                LOG_WARNING("读取数据大于可读空间大小!");
             }
         }
 
         void write(const char* _data, size_t _len) {
+            if (_len == 0) {
+                return;
+            }
             write_check(_len);
-            std::copy(_data, _data + _len, get_write_idx());
+            struct iovec vec[2];
+            int count = write_spans(vec);
+            size_t remain = _len;
+            for (int i = 0; i < count && remain > 0; i++) {
+                size_t len = std::min(remain, vec[i].iov_len);
+                std::copy(_data, _data + len, static_cast<char*>(vec[i].iov_base));
+                _data += len;
+                remain -= len;
+            }
             move_write(_len);
         }
 
@@ -102,7 +294,11 @@ namespace muduo
         }
 
         void write_buffer(Buffer& _buffer) {
-            write(_buffer.get_read_idx(), _buffer.read_able_size());
+            struct iovec vec[2];
+            int count = _buffer.peek_spans(vec);
+            for (int i = 0; i < count; i++) {
+                write(static_cast<const char*>(vec[i].iov_base), vec[i].iov_len);
+            }
         }
 
         std::string read_string(size_t _len) {
@@ -113,21 +309,28 @@ namespace muduo
         }
 
         std::string get_line() {
-            const char* ptr = buffer.data() + read_idx;
-            const char* pos = std::find(ptr, ptr + read_able_size(), '\n');
-
-            if (pos != ptr + write_idx) {
-                return read_string(pos - ptr + 1);
-            }
-            else {
-                logging.warning("缓冲区读取失败, 行数不足一行!");
-                return "";
+            struct iovec vec[2];
+            int count = peek_spans(vec);
+            size_t offset = 0;
+            for (int i = 0; i < count; i++) {
+                const char* ptr = static_cast<const char*>(vec[i].iov_base);
+                const char* pos = std::find(ptr, ptr + vec[i].iov_len, '\n');
+                if (pos != ptr + vec[i].iov_len) {
+                    return read_string(offset + (pos - ptr) + 1);
+                }
+                offset += vec[i].iov_len;
             }
+            LOG_WARNING("缓冲区读取失败, 行数不足一行!");
+            return "";
         }
 
+        //使用池的缓冲区同时归还存储空间
         void clear() {
             read_idx = 0;
             write_idx = 0;
+            if (pool != nullptr) {
+                free_storage();
+            }
         }
     };
-}
\ No newline at end of file
+}
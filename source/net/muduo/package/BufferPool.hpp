@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace muduo
+{
+    //每个 EventLoop 一个的定长内存块池, 只在所属loop线程中使用, 不加锁
+    //连接的输入缓冲区有数据时才从池中取一块, 数据被取空后归还, 空闲连接不占用缓冲区内存
+    class BufferPool
+    {
+    public:
+        static const size_t chunk_size = 65536; //每块的大小, 与原先缓冲区的默认大小一致
+
+    private:
+        static const size_t max_free_chunks = 256; //最多缓存的空闲块数, 超出的直接释放
+
+        std::vector<char*> free_chunks;
+        size_t lent_count; //已经借出尚未归还的块数
+
+    public:
+        BufferPool()
+            : lent_count(0) {}
+
+        ~BufferPool() {
+            for (char* chunk : free_chunks) {
+                delete[] chunk;
+            }
+        }
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        char* acquire() {
+            lent_count++;
+            if (free_chunks.empty()) {
+                return new char[chunk_size];
+            }
+            char* chunk = free_chunks.back();
+            free_chunks.pop_back();
+            return chunk;
+        }
+
+        void release(char* _chunk) {
+            lent_count--;
+            if (free_chunks.size() >= max_free_chunks) {
+                delete[] _chunk;
+                return;
+            }
+            free_chunks.push_back(_chunk);
+        }
+
+        size_t get_lent_count() {
+            return lent_count;
+        }
+
+        size_t get_free_count() {
+            return free_chunks.size();
+        }
+    };
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <sys/uio.h>
+#include "../../../util/Log.hpp"
+
+namespace muduo
+{
+    //链式输出缓冲区, 由引用计数的数据块组成
+    //发送的数据以块为单位挂到队尾, 不再拷贝进一整块连续内存, 发送时用 writev 一次性聚集写出
+    class ChainBuffer
+    {
+    public:
+        using Chunk = std::shared_ptr<const std::string>;
+
+    private:
+        std::deque<Chunk> chunks;
+        size_t head_offset; //队首数据块中已经发送的字节数
+        size_t total_size; //尚未发送的总字节数
+
+    public:
+        ChainBuffer()
+            : head_offset(0), total_size(0) {}
+
+        size_t read_able_size() {
+            return total_size;
+        }
+
+        bool empty() {
+            return total_size == 0;
+        }
+
+        //_offset 为数据块中已经发送过的字节数, 只有缓冲区为空时才能指定
+        void append(const Chunk& _chunk, size_t _offset = 0) {
+            if (_offset >= _chunk->size()) {
+                return;
+            }
+            if (!chunks.empty() && _offset != 0) {
+                LOG_ERROR("链式缓冲区非空时不能追加已部分发送的数据块!");
+                return;
+            }
+            if (chunks.empty()) {
+                head_offset = _offset;
+            }
+            total_size += _chunk->size() - _offset;
+            chunks.emplace_back(_chunk);
+        }
+
+        //把待发送的数据块填入iovec, 返回填入的个数
+        int peek_iovec(struct iovec* _vec, int _max_count) {
+            int count = 0;
+            size_t offset = head_offset;
+            for (auto it = chunks.begin(); it != chunks.end() && count < _max_count; ++it) {
+                _vec[count].iov_base = const_cast<char*>((*it)->data()) + offset;
+                _vec[count].iov_len = (*it)->size() - offset;
+                offset = 0;
+                count++;
+            }
+            return count;
+        }
+
+        //队首的数据块, 缓冲区为空时不能调用
+        const Chunk& front() {
+            return chunks.front();
+        }
+
+        //队首数据块中已经发送的字节数
+        size_t front_offset() {
+            return head_offset;
+        }
+
+        //已经发送了_len字节, 释放发送完毕的数据块
+        void move_read(size_t _len) {
+            if (_len > total_size) {
+                LOG_ERROR("链式缓冲区读取下标移动错误!");
+                _len = total_size;
+            }
+            total_size -= _len;
+            while (_len > 0) {
+                size_t remain = chunks.front()->size() - head_offset;
+                if (_len < remain) {
+                    head_offset += _len;
+                    return;
+                }
+                _len -= remain;
+                head_offset = 0;
+                chunks.pop_front();
+            }
+        }
+
+        void clear() {
+            chunks.clear();
+            head_offset = 0;
+            total_size = 0;
+        }
+    };
+}
@@ -2,7 +2,9 @@
 
 #include <iostream>
 #include <functional>
+#include <memory>
 #include <sys/epoll.h>
+#include <sys/socket.h>
 #include "../../../util/Log.hpp"
 
 namespace muduo
@@ -14,16 +16,25 @@ namespace muduo
     {
     private:
         using func_t = std::function<void()>;
+        using recv_func = std::function<void(const char*, ssize_t)>;
+        using send_func = std::function<void(ssize_t)>;
 
         int fd;
         EventLoop* loop;
         uint32_t event; //感兴趣的事件
         uint32_t revent; //已经发生了的事件
+        bool registered; //是否已经添加到epoller中
+        uint32_t backend_index; //在 io_uring 后端中的槽位下标
+        bool ring_read; //可读事件是否由 io_uring 的 multishot recv 承担, 由后端在注册时设置
+        bool tied; //是否绑定了持有者
+        std::weak_ptr<void> tie_ptr; //持有者, 处理事件期间保证其不被释放
         func_t read_cb; //可读回调
         func_t write_cb; //可写回调
         func_t error_cb; //错误回调
         func_t close_cb; //断开连接回调
         func_t event_cb; //任意事件回调
+        recv_func recv_cb; //io_uring 后端收到数据时调用, 长度为0表示对端关闭, 为负表示出错(-errno)
+        send_func send_done_cb; //io_uring 后端提交的发送完成时调用, 参数为发送的字节数或 -errno
 
     private:
         void update();
@@ -31,11 +42,11 @@ namespace muduo
     public:
 
         Channel(int _fd, EventLoop* _loop)
-            : fd(_fd), loop(_loop), event(0), revent(0) {
+            : fd(_fd), loop(_loop), event(0), revent(0), registered(false), backend_index(0), ring_read(false), tied(false) {
         }
 
         ~Channel() {
-            // logging.debug("Channel::~Channel()");
+            // LOG_DEBUG("Channel::~Channel()");
         }
 
         void remove();
@@ -56,36 +67,92 @@ namespace muduo
             return loop;
         }
 
+        bool is_registered() {
+            return registered;
+        }
+
+        //由epoller在添加/移除时设置
+        void set_registered(bool _registered) {
+            registered = _registered;
+        }
+
+        uint32_t get_backend_index() {
+            return backend_index;
+        }
+
+        //由 io_uring 后端在添加时设置
+        void set_backend_index(uint32_t _index) {
+            backend_index = _index;
+        }
+
+        bool is_ring_read() {
+            return ring_read;
+        }
+
+        //由 io_uring 后端在添加时设置, 内核不支持 multishot recv 时改回 false
+        void set_ring_read(bool _ring_read) {
+            ring_read = _ring_read;
+        }
+
+        bool has_recv_cb() {
+            return static_cast<bool>(recv_cb);
+        }
+
+        //由 io_uring 后端调用, 把内核收到的数据交给持有者
+        void deliver(const char* _data, ssize_t _len) {
+            recv_cb(_data, _len);
+        }
+
+        //由 io_uring 后端调用, 通知 submit_send 提交的发送已经完成
+        void send_done(ssize_t _res) {
+            if (send_done_cb) {
+                send_done_cb(_res);
+            }
+        }
+
+        //通过 io_uring 提交一次发送, 与下一次等待合并为一次系统调用
+        //_hold 保证 _msg 及其中的数据在完成之前有效; 后端不是 io_uring 或提交队列已满时返回 false
+        bool submit_send(const struct msghdr* _msg, const std::shared_ptr<void>& _hold);
+
         //epoller检测到了事件，在此设置
         void set_event(uint32_t _event) {
             revent = _event;
         }
 
         void set_read_cb(const func_t& _cb) {
-            //logging.debug("fd: %d, 被设置读事件回调: %p", fd, read_cb);
+            //LOG_DEBUG("fd: %d, 被设置读事件回调: %p", fd, read_cb);
             read_cb = _cb;
         }
 
         void set_write_cb(const func_t& _cb) {
-            //logging.debug("fd: %d, 被设置写事件回调: %p", fd, write_cb);
+            //LOG_DEBUG("fd: %d, 被设置写事件回调: %p", fd, write_cb);
             write_cb = _cb;
         }
 
         void set_error_cb(const func_t& _cb) {
-            //logging.debug("fd: %d, 被设置错误事件回调: %p", fd, error_cb);
+            //LOG_DEBUG("fd: %d, 被设置错误事件回调: %p", fd, error_cb);
             error_cb = _cb;
         }
 
         void set_close_cb(const func_t& _cb) {
-            //logging.debug("fd: %d, 被设置断连事件回调: %p", fd, close_cb);
+            //LOG_DEBUG("fd: %d, 被设置断连事件回调: %p", fd, close_cb);
             close_cb = _cb;
         }
 
         void set_event_cb(const func_t& _cb) {
-            //logging.debug("fd: %d, 被设置任意事件回调: %p", fd, event_cb);
+            //LOG_DEBUG("fd: %d, 被设置任意事件回调: %p", fd, event_cb);
             event_cb = _cb;
         }
 
+        //设置后, io_uring 后端改用 multishot recv 接收数据, 先调用 _cb 交付数据, 再照常触发可读回调
+        void set_recv_cb(const recv_func& _cb) {
+            recv_cb = _cb;
+        }
+
+        void set_send_done_cb(const send_func& _cb) {
+            send_done_cb = _cb;
+        }
+
         //可读
         bool read_able() {
             return event & EPOLLIN;
@@ -96,42 +163,65 @@ namespace muduo
             return event & EPOLLOUT;
         }
 
+        //是否为边缘触发
+        bool edge_trigger() {
+            return event & EPOLLET;
+        }
+
+        //启用边缘触发, 在下一次 enable_read/enable_write 时随事件一起注册
+        void enable_edge_trigger() {
+            event |= EPOLLET;
+        }
+
         //启用可读状态
         void enable_read() {
-            // logging.debug("fd: %d, 启用可读状态!", fd);
+            // LOG_DEBUG("fd: %d, 启用可读状态!", fd);
             event |= EPOLLIN;
             update();
         }
 
         //启用可写状态
         void enable_write() {
-            // logging.debug("fd: %d, 启用可写状态!", fd);
+            // LOG_DEBUG("fd: %d, 启用可写状态!", fd);
             event |= EPOLLOUT;
             update();
         }
 
         //关闭可读状态
         void disable_read() {
-            // logging.debug("fd: %d, 关闭可读状态!", fd);
+            // LOG_DEBUG("fd: %d, 关闭可读状态!", fd);
             event &= ~EPOLLIN;
             update();
         }
 
         //关闭可写状态
         void disable_write() {
-            // logging.debug("fd: %d, 关闭可写状态!", fd);
+            // LOG_DEBUG("fd: %d, 关闭可写状态!", fd);
             event &= ~EPOLLOUT;
             update();
         }
 
         void disable_all() {
-            // logging.debug("fd: %d, 清除了所有的状态!", fd);
+            // LOG_DEBUG("fd: %d, 清除了所有的状态!", fd);
             event = 0;
             update();
         }
 
+        //绑定持有该channel的对象, 回调中关闭连接时, 连接要到本次事件处理完才析构
+        void tie(const std::shared_ptr<void>& _owner) {
+            tie_ptr = _owner;
+            tied = true;
+        }
+
         //执行回调函数    
         void handler_event() {
+            std::shared_ptr<void> guard;
+            if (tied) {
+                guard = tie_ptr.lock();
+                if (!guard) {
+                    return;
+                }
+            }
             // 可读 / 关闭连接 / 优先级事件
             if ((revent & EPOLLIN) || (revent & EPOLLRDHUP) || (revent & EPOLLPRI)) {
                 if (read_cb) {
@@ -141,21 +231,21 @@ namespace muduo
             //可写
             if (revent & EPOLLOUT) {
                 if (write_cb) {
-                    // logging.debug("fd: %d, 调用了写事件回调函数: %p!", fd, write_cb);
+                    // LOG_DEBUG("fd: %d, 调用了写事件回调函数: %p!", fd, write_cb);
                     write_cb();
                 }
             }
             //错误
             else if (revent & EPOLLERR) {
                 if (error_cb) {
-                    // logging.debug("fd: %d, 调用了错误事件回调函数: %p!", fd, error_cb);
+                    // LOG_DEBUG("fd: %d, 调用了错误事件回调函数: %p!", fd, error_cb);
                     error_cb();
                 }
             }
             //先读取完缓冲区的数据, 再关闭
             else if (revent & EPOLLHUP) {
                 if (close_cb) {
-                    // logging.debug("fd: %d, 调用了断连事件回调函数: %p!", fd, close_cb);
+                    // LOG_DEBUG("fd: %d, 调用了断连事件回调函数: %p!", fd, close_cb);
                     close_cb();
                 }
             }
@@ -2,7 +2,10 @@
 
 #include <memory>
 #include <functional>
+#include <atomic>
+#include <deque>
 #include "Buffer.hpp"
+#include "ChainBuffer.hpp"
 #include "Any.hpp"
 #include "Socket.hpp"
 #include "Channel.hpp"
@@ -25,10 +28,15 @@ namespace muduo
         using msg_func = std::function<void(ptr, Buffer*)>;
         using close_func = std::function<void(ptr)>;
         using event_func = std::function<void(ptr)>;
+        using water_func = std::function<void(ptr, size_t)>; //第二个参数为当前发送缓冲区中的字节数
 
     private:
 
         static const int buffer_size = 65536;
+        static const int read_budget = 16; //单次可读事件最多读取的次数, 防止一个连接饿死同一loop中的其他连接
+        static const int max_iovec = 64; //单次writev最多聚集的数据块数
+        static const int ring_iovec = 16; //单次 io_uring 发送最多聚集的数据块数
+        static const uint32_t zerocopy_linger_ms = 10000; //连接关闭时仍未收到完成通知的零拷贝数据块, 延迟释放的时间
         //DISCONNECTED 关闭状态
         //CONNECTING 连接建立完成,待处理状态
         //CONNECTED 连接可通信状态
@@ -44,13 +52,29 @@ namespace muduo
         uint64_t id; //连接ID
 
         bool inactive_release; //是否启用非活跃销毁
+        uint32_t idle_timeout; //非活跃销毁的超时时间(毫秒)
+        uint64_t last_active; //最近一次有事件的tick, 定时器到期时才比较
+        TimerTask idle_timer; //内嵌的非活跃定时器节点, 不需要额外分配
+        bool edge_trigger; //是否使用边缘触发
+        bool reading; //是否在监控可读事件, stop_read 后为 false
+        size_t high_water_mark; //发送缓冲区超过该值时触发 high_water_cb, 0 表示不检查
+        size_t low_water_mark; //超过高水位后, 发送缓冲区回落到该值以下时触发 low_water_cb
+        std::atomic<bool> above_high_water; //发送缓冲区是否处于高水位, 其他线程可以读取
+        bool zerocopy_enabled; //套接字是否开启了 SO_ZEROCOPY
+        size_t zerocopy_threshold; //不小于该大小的数据块以 MSG_ZEROCOPY 发送, 0 表示不使用
+        uint32_t zerocopy_seq; //下一次零拷贝发送的序号, 与内核的计数保持一致
+        std::deque<std::pair<uint32_t, ChainBuffer::Chunk>> zerocopy_pending; //已提交但内核尚未用完的数据块
+        bool ring_sending; //是否有提交给 io_uring 的发送尚未完成, 期间不再同步写
+        bool peer_closed; //io_uring 收到了对端关闭或接收错误, 由下一次读回调关闭连接
+        struct msghdr ring_msg; //提交给 io_uring 的发送参数, 完成之前保持不变
+        struct iovec ring_vec[ring_iovec];
         Status status; //连接状态
         // Socket socket; //套接字操作
         std::unique_ptr<Socket> socket; //套接字操作
         Channel conn_channel; //关联的Channel
         EventLoop* loop; //连接事件管理
-        Buffer in_buffer; //输入缓冲区
-        Buffer out_buffer; //输出缓冲区
+        Buffer in_buffer; //输入缓冲区, 有数据时才从所属loop的内存池借用存储
+        ChainBuffer out_buffer; //输出缓冲区, 由待发送的数据块串成
         Any context; //接收的数据
 
         conn_func conn_cb;
@@ -59,41 +83,193 @@ namespace muduo
         event_func event_cb;
 
         close_func server_close_cb; //组件内的连接关闭回调
+        water_func high_water_cb;
+        water_func low_water_cb;
         
 
     private:
 
         //设置到连接的channel中的读回调, 此时描述符应可读
+        //readv 先填满 in_buffer 的空闲空间(环形模式下可能是两段), 放不下的部分才落到栈上的溢出区再追加进 in_buffer
+        //绝大多数情况下数据只经过一次内核拷贝就进入 in_buffer
         void handler_read() {
-            //接收socket的数据，放到缓冲区
-            char buf[buffer_size];
-            int ret = socket->non_block_recv(buf, buffer_size - 1);
-            if(ret < 0){
-                shutdown();
+            if (reading == false) {
                 return;
             }
-            in_buffer.write(buf, ret);
+            //io_uring 后端已经把数据收进了 in_buffer, 这里只需要交给上层
+            if (conn_channel.is_ring_read()) {
+                if (peer_closed) {
+                    shutdown();
+                    return;
+                }
+                if (in_buffer.read_able_size() > 0) {
+                    msg_cb(shared_from_this(), &in_buffer);
+                }
+                else {
+                    in_buffer.clear();
+                }
+                return;
+            }
+            char extra_buf[buffer_size];
+            bool drained = false;
+            for (int i = 0; i < read_budget; i++) {
+                in_buffer.reserve(1);
+                struct iovec vec[3];
+                int count = in_buffer.write_spans(vec);
+                size_t write_able = 0;
+                for (int j = 0; j < count; j++) {
+                    write_able += vec[j].iov_len;
+                }
+                //in_buffer 本身的空间不足 extra_buf 时才带上 extra_buf, capacity 为这次 readv 实际能读的字节数
+                size_t capacity = write_able;
+                if (write_able < sizeof(extra_buf)) {
+                    vec[count].iov_base = extra_buf;
+                    vec[count].iov_len = sizeof(extra_buf);
+                    count++;
+                    capacity += sizeof(extra_buf);
+                }
+                ssize_t ret = socket->readv(vec, count);
+                if (ret < 0) {
+                    shutdown();
+                    return;
+                }
+                if (ret == 0) {
+                    drained = true;
+                    break;
+                }
+                if (static_cast<size_t>(ret) <= write_able) {
+                    in_buffer.move_write(ret);
+                }
+                else {
+                    in_buffer.move_write(write_able);
+                    in_buffer.write(extra_buf, ret - write_able);
+                }
+                //没有读满说明内核接收缓冲区已经读空, 水平触发下不必再多一次 EAGAIN 的系统调用
+                //边缘触发下必须读到 EAGAIN 为止
+                if (!edge_trigger && static_cast<size_t>(ret) < capacity) {
+                    drained = true;
+                    break;
+                }
+            }
             if (in_buffer.read_able_size() > 0) {
                 //调用message_callback进行业务处理
                 msg_cb(shared_from_this(), &in_buffer);
             }
+            else {
+                //什么都没读到, 把借来的存储还回去
+                in_buffer.clear();
+            }
+            //边缘触发下没读到 EAGAIN 就不会再有可读事件, 预算用完时把剩下的读取放到任务池, 先让同一loop中的其他连接处理
+            if (edge_trigger && !drained && status == CONNECTED) {
+                loop->push_task(std::bind(&Connection::continue_read_in_loop, shared_from_this()));
+            }
         }
 
-        //设置到连接的channel中的写回调, 此时描述符应可写
-        void handler_write() {
-            ssize_t ret = socket->non_block_send(out_buffer.get_read_idx(), out_buffer.read_able_size());
-            if (ret < 0) {
+        void continue_read_in_loop() {
+            if (status == CONNECTED) {
+                handler_read();
+            }
+        }
+
+        //io_uring 后端收到数据时调用, 数据追加到 in_buffer, 随后的可读回调再交给上层
+        void handler_ring_recv(const char* _data, ssize_t _len) {
+            if (_len > 0) {
+                in_buffer.write(_data, _len);
+                return;
+            }
+            if (_len < 0) {
+                LOG_ERROR("Socket_fd: %d, 接收错误: %s!", info.fd, strerror(-_len));
+            }
+            peer_closed = true;
+        }
+
+        //把发送缓冲区前面的数据块提交给 io_uring, 在本轮结束时与等待一起交给内核
+        //channel尚未注册或提交队列已满时交给可写事件同步写
+        void submit_ring_send() {
+            int count = out_buffer.peek_iovec(ring_vec, ring_iovec);
+            memset(&ring_msg, 0, sizeof(ring_msg));
+            ring_msg.msg_iov = ring_vec;
+            ring_msg.msg_iovlen = count;
+            if (conn_channel.submit_send(&ring_msg, shared_from_this())) {
+                ring_sending = true;
+                //水平触发下可写事件在发送完成前没有用处, 关掉以免每轮都被唤醒
+                if (!edge_trigger && conn_channel.write_able()) {
+                    conn_channel.disable_write();
+                }
+                return;
+            }
+            if (conn_channel.write_able() == false) {
+                conn_channel.enable_write();
+            }
+        }
+
+        //io_uring 发送完成, 同一连接同时只有一个发送在途, 完成后再提交剩下的数据, 保证顺序
+        void handler_ring_send(ssize_t _res) {
+            ring_sending = false;
+            if (_res < 0) {
+                //较早的内核对非阻塞套接字直接返回 EAGAIN, 不会等待可写
+                if (_res == -EAGAIN || _res == -EINTR) {
+                    if (conn_channel.write_able() == false) {
+                        conn_channel.enable_write();
+                    }
+                    return;
+                }
+                LOG_ERROR("Socket_fd: %d, 发送错误: %s!", info.fd, strerror(-_res));
                 if (in_buffer.read_able_size() > 0) {
                     msg_cb(shared_from_this(), &in_buffer);
                 }
                 release();
                 return;
-                //处理完接收缓冲区后关闭释放
             }
-            //上面是直接在缓冲区中读取数据发送，没调用接口，所以要用move_read移动读指针
-            out_buffer.move_read(ret);
+            out_buffer.move_read(_res);
+            check_low_water();
+            if (!out_buffer.empty()) {
+                submit_ring_send();
+                return;
+            }
+            if (status == DISCONNECTING) {
+                release();
+            }
+        }
+
+        //io_uring 后端且没有使用零拷贝时, 发送交给 io_uring
+        bool use_ring_send() {
+            return zerocopy_threshold == 0 && loop->get_backend() == Epoller::IO_URING;
+        }
+
+        //设置到连接的channel中的写回调, 此时描述符应可写
+        //边缘触发下可写事件常驻, 一直写到缓冲区为空或 EAGAIN 为止
+        void handler_write() {
+            if (out_buffer.empty() || ring_sending) {
+                return;
+            }
+            ssize_t ret = 0;
+            do {
+                //大数据块单独以零拷贝方式发送, 其余的仍然聚集写
+                if (zerocopy_threshold > 0 && out_buffer.front()->size() - out_buffer.front_offset() >= zerocopy_threshold) {
+                    ret = send_chunk(out_buffer.front(), out_buffer.front_offset());
+                }
+                else {
+                    struct iovec vec[max_iovec];
+                    int count = out_buffer.peek_iovec(vec, max_iovec);
+                    ret = socket->writev(vec, count);
+                }
+                if (ret < 0) {
+                    if (in_buffer.read_able_size() > 0) {
+                        msg_cb(shared_from_this(), &in_buffer);
+                    }
+                    release();
+                    return;
+                    //处理完接收缓冲区后关闭释放
+                }
+                //释放已经发送完毕的数据块
+                out_buffer.move_read(ret);
+            } while (edge_trigger && ret > 0 && !out_buffer.empty());
+            check_low_water();
             if (out_buffer.read_able_size() == 0) {
-                conn_channel.disable_write();
+                if (!edge_trigger) {
+                    conn_channel.disable_write();
+                }
                 if (status == DISCONNECTING) {
                     release();
                 }
@@ -110,14 +286,89 @@ namespace muduo
         }
 
         //设置到连接的channel中的错误回调, 描述符出错时触发
+        //错误队列中只有零拷贝完成通知时也会报告 EPOLLERR, 此时不是真正的错误, 不能关闭连接
         void handler_error() {
+            if (zerocopy_enabled && handler_zerocopy() > 0) {
+                return;
+            }
             handler_close();
         }
 
+        //读取零拷贝完成通知, 释放内核已经用完的数据块, 返回读到的通知数
+        //内核实际上做了拷贝(回环网卡, 不支持分散/聚集的网卡)时, 零拷贝只会更慢, 之后这个连接改用普通发送
+        int handler_zerocopy() {
+            return socket->recv_zerocopy_notify([this](uint32_t _lo, uint32_t _hi, bool _copied) {
+                for (auto it = zerocopy_pending.begin(); it != zerocopy_pending.end();) {
+                    if (it->first - _lo <= _hi - _lo) {
+                        it = zerocopy_pending.erase(it);
+                    }
+                    else {
+                        ++it;
+                    }
+                }
+                if (_copied && zerocopy_threshold > 0) {
+                    LOG_INFO("连接 %s:%d 的零拷贝发送被内核退化为拷贝, 改用普通发送", info.ip.c_str(), info.port);
+                    zerocopy_threshold = 0;
+                }
+            });
+        }
+
+        //发送一个数据块中从 _offset 开始的部分, 足够大时使用零拷贝并保留数据块直到内核用完
+        ssize_t send_chunk(const ChainBuffer::Chunk& _chunk, size_t _offset) {
+            const char* data = _chunk->data() + _offset;
+            size_t len = _chunk->size() - _offset;
+            if (zerocopy_threshold == 0 || len < zerocopy_threshold) {
+                return socket->send(data, len, MSG_DONTWAIT);
+            }
+            bool pinned = false;
+            ssize_t ret = socket->send_zerocopy(data, len, pinned);
+            if (pinned) {
+                zerocopy_pending.emplace_back(zerocopy_seq++, _chunk);
+            }
+            return ret;
+        }
+
+        void enable_zerocopy_in_loop(size_t _threshold) {
+            //unix 套接字不支持 MSG_ZEROCOPY, 数据直接拷贝到对端的接收队列, 不必告警
+            if (Socket::is_unix_address(info.ip)) {
+                return;
+            }
+            if (zerocopy_enabled == false) {
+                zerocopy_enabled = socket->enable_zerocopy();
+            }
+            if (zerocopy_enabled == false) {
+                LOG_WARNING("连接 %s:%d 不支持零拷贝发送, 使用普通发送", info.ip.c_str(), info.port);
+                return;
+            }
+            zerocopy_threshold = _threshold;
+        }
+
+        //连接关闭后内核可能仍在发送已经提交的零拷贝数据, 把数据块交给一个定时器, 延迟一段时间再释放
+        void linger_zerocopy_in_loop() {
+            if (zerocopy_pending.empty()) {
+                return;
+            }
+            struct Holder
+            {
+                std::deque<std::pair<uint32_t, ChainBuffer::Chunk>> chunks;
+                TimerTask timer;
+
+                Holder() : timer(0, 0, [this]() { delete this; }) {}
+            };
+            Holder* holder = new Holder();
+            holder->chunks.swap(zerocopy_pending);
+            loop->timer_add_node(&holder->timer, loop->now_tick() + zerocopy_linger_ms);
+        }
+
         //设置到连接的channel中的常规事件回调
+        //只记录活跃时间, 不触碰时间轮
         void handler_event() {
             if (inactive_release == true) {
-                loop->timer_refresh(id);
+                last_active = loop->now_tick();
+            }
+            //同时可写时错误回调不会被调用, 在这里读取零拷贝完成通知
+            if (!zerocopy_pending.empty() && (conn_channel.get_revent() & EPOLLERR)) {
+                handler_zerocopy();
             }
             if (event_cb) {
                 event_cb(shared_from_this());
@@ -129,11 +380,21 @@ namespace muduo
             //修改连接状态
             if(status != CONNECTING)
             {
-                logging.fatal("Connection::established_in_loop 错误! 连接状态不为预期状态");
+                LOG_FATAL("Connection::established_in_loop 错误! 连接状态不为预期状态");
                 abort();
             }
             status = CONNECTED;
-            conn_channel.enable_read();
+            reading = true;
+            conn_channel.tie(shared_from_this());
+            if (edge_trigger) {
+                //边缘触发: 可读可写事件一次注册, 之后不再修改
+                conn_channel.enable_edge_trigger();
+                conn_channel.enable_read();
+                conn_channel.enable_write();
+            }
+            else {
+                conn_channel.enable_read();
+            }
             if (conn_cb) {
                 conn_cb(shared_from_this());
             }
@@ -142,18 +403,20 @@ namespace muduo
         //释放接口
         void release_in_loop() {
             if (status != DISCONNECTING) {
-                logging.warning("连接已经被释放，跳过重复释放操作");
+                LOG_WARNING("连接已经被释放，跳过重复释放操作");
                 return;
             }
             status = DISCONNECTED;
+            loop->connection_closed();
             //取消事件关心
             conn_channel.disable_all();
             //移除连接的事件监控
             conn_channel.remove();
+            //在loop线程中把输入缓冲区的存储还给内存池
+            in_buffer.clear();
+            linger_zerocopy_in_loop();
             //取消定时销毁任务
-            if(loop->has_timer(id)) {
-                disable_inactive_release_in_loop();
-            }
+            disable_inactive_release_in_loop();
             //调用关闭回调函数
             if (close_cb) {
                 close_cb(shared_from_this());
@@ -163,22 +426,87 @@ namespace muduo
             }
         }
         
-        //数据放到了发送缓冲区，启动可写事件监控
-        void send_in_loop(Buffer& _buffer) {
-            if (DISCONNECTED) {
+        //发送缓冲区为空时先直接写socket, 只有没写完的部分才挂到发送缓冲区并启动可写事件监控
+        //小响应通常一次就能写完, 省去 enable_write/epoll_wait/disable_write 三次系统调用
+        void send_in_loop(const ChainBuffer::Chunk& _chunk) {
+            if (status == DISCONNECTED) {
                 return;
             }
-            // 读取前四个字节强转成uint32_t，先打印原始数据，再打印从网络字节序转换后的数据
-            out_buffer.write_buffer(_buffer);
+            if (use_ring_send()) {
+                out_buffer.append(_chunk, 0);
+                if (!ring_sending) {
+                    submit_ring_send();
+                }
+                check_high_water();
+                return;
+            }
+            size_t written = 0;
+            if (out_buffer.empty()) {
+                ssize_t ret = send_chunk(_chunk, 0);
+                if (ret < 0) {
+                    //发送出错, 丢弃数据, 连接交给随后的读事件/错误事件关闭
+                    return;
+                }
+                written = ret;
+                if (written == _chunk->size()) {
+                    return;
+                }
+            }
+            out_buffer.append(_chunk, written);
             if (conn_channel.write_able() == false) {
                 conn_channel.enable_write();
             }
+            check_high_water();
+        }
+
+        //水位回调放到任务池中执行, 回调中再次发送/关闭连接时不会重入发送路径
+        void check_high_water() {
+            size_t pending = out_buffer.read_able_size();
+            if (high_water_mark == 0 || above_high_water || pending < high_water_mark) {
+                return;
+            }
+            above_high_water = true;
+            if (high_water_cb) {
+                loop->push_task(std::bind(high_water_cb, shared_from_this(), pending));
+            }
+        }
+
+        void check_low_water() {
+            size_t pending = out_buffer.read_able_size();
+            if (!above_high_water || pending > low_water_mark) {
+                return;
+            }
+            above_high_water = false;
+            if (low_water_cb) {
+                loop->push_task(std::bind(low_water_cb, shared_from_this(), pending));
+            }
+        }
+
+        void stop_read_in_loop() {
+            if (reading == false || status != CONNECTED) {
+                return;
+            }
+            reading = false;
+            conn_channel.disable_read();
+        }
+
+        //重新注册可读事件时 epoll 会重新检查就绪状态, 暂停期间积压的数据在边缘触发下也能读到
+        void start_read_in_loop() {
+            if (reading == true || status != CONNECTED) {
+                return;
+            }
+            reading = true;
+            conn_channel.enable_read();
+            //io_uring 后端在暂停之前可能已经收进了一部分数据, 这些数据不会再有可读事件
+            if (conn_channel.is_ring_read() && (in_buffer.read_able_size() > 0 || peer_closed)) {
+                loop->push_task(std::bind(&Connection::continue_read_in_loop, shared_from_this()));
+            }
         }
 
         //loop中先将数据处理完毕, 再将连接关闭
         void shutdown_in_loop() {
             if (status != CONNECTED) {
-                logging.warning("连接已经被释放，跳过重复释放操作");
+                LOG_WARNING("连接已经被释放，跳过重复释放操作");
                 return;
             }
             status = DISCONNECTING;
@@ -187,7 +515,8 @@ namespace muduo
                     msg_cb(shared_from_this(), &in_buffer);
                 }
             }
-            if (out_buffer.read_able_size() > 0) {
+            //io_uring 发送在途时由发送完成回调继续发送并释放
+            if (out_buffer.read_able_size() > 0 && !ring_sending) {
                 if (conn_channel.write_able() == false) {
                     conn_channel.enable_write();
                 }
@@ -199,29 +528,38 @@ namespace muduo
 
         void disconnect_in_loop() {
             if (status == DISCONNECTED) {
-                logging.warning("连接已经被释放，跳过重复释放操作");
+                LOG_WARNING("连接已经被释放，跳过重复释放操作");
                 return;
             }
-            if (!conn_channel.write_able()) {
+            if (out_buffer.empty()) {
                 ::shutdown(info.fd, SHUT_WR);
             }
         }
 
         void enable_inactive_release_in_loop(int _second) {
             inactive_release = true;
-            if (loop->has_timer(id)) {
-                loop->timer_refresh(id);
-            }
-            else {
-                loop->timer_add(id, _second, std::bind(&Connection::release_in_loop, this));
-            }
+            idle_timeout = _second * 1000;
+            last_active = loop->now_tick();
+            loop->timer_add_node(&idle_timer, last_active + idle_timeout + 1);
         }
 
         void disable_inactive_release_in_loop() {
             inactive_release = false;
-            if (loop->has_timer(id)) {
-                loop->timer_cancel(id);
+            loop->timer_cancel_node(&idle_timer);
+        }
+
+        //非活跃定时器到期: 期间有过事件就按最近的活跃时间重新挂上, 否则关闭连接
+        void handler_idle() {
+            if (inactive_release == false || status != CONNECTED) {
+                return;
+            }
+            uint64_t deadline = last_active + idle_timeout + 1;
+            if (deadline > loop->now_tick()) {
+                loop->timer_add_node(&idle_timer, deadline);
+                return;
             }
+            LOG_INFO("连接 %s:%d 长时间不活跃, 关闭连接", info.ip.c_str(), info.port);
+            shutdown_in_loop();
         }
 
         void upgrade_in_loop(const Any& _context, const conn_func& _conn_cb, const msg_func& _msg_cb, const close_func& _close_cb, const event_func& _event_cb) {
@@ -233,16 +571,25 @@ namespace muduo
         }
     public:
         Connection(EventLoop* _loop, uint64_t _id, const Connection::Info& _info)
-            : info(_info), loop(_loop), id(_id), inactive_release(false), status(CONNECTING), socket(new Socket(info.fd, Socket::IPV4_TCP)), conn_channel(info.fd, _loop) {
+            : info(_info), loop(_loop), id(_id), inactive_release(false), idle_timeout(0), last_active(0), idle_timer(_id, 0, std::bind(&Connection::handler_idle, this)), edge_trigger(false), reading(false), high_water_mark(0), low_water_mark(0), above_high_water(false), zerocopy_enabled(false), zerocopy_threshold(0), zerocopy_seq(0), ring_sending(false), peer_closed(false), status(CONNECTING), socket(new Socket(info.fd, Socket::protocol_of(info.ip))), conn_channel(info.fd, _loop), in_buffer(_loop->get_buffer_pool()) {
+            //读写都要能在 EAGAIN 处停下, 连接上的socket必须是非阻塞的
+            //Acceptor(accept4) 和 Connector 创建的套接字已经是非阻塞的, 这里不再额外调用 fcntl
             conn_channel.set_close_cb(std::bind(&Connection::handler_close, this));
             conn_channel.set_event_cb(std::bind(&Connection::handler_event, this));
             conn_channel.set_read_cb(std::bind(&Connection::handler_read, this));
             conn_channel.set_write_cb(std::bind(&Connection::handler_write, this));
             conn_channel.set_error_cb(std::bind(&Connection::handler_error, this));
+            conn_channel.set_recv_cb(std::bind(&Connection::handler_ring_recv, this, std::placeholders::_1, std::placeholders::_2));
+            conn_channel.set_send_done_cb(std::bind(&Connection::handler_ring_send, this, std::placeholders::_1));
+            //在创建时就计入所属loop的连接数, 连接风暴中按连接数分配时不会因为尚未就绪而全部落到同一个loop
+            loop->connection_opened();
         }
 
         ~Connection() {
-            logging.debug("释放连接: %s:%d", info.ip.c_str(), info.port);
+            LOG_DEBUG("释放连接: %s:%d", info.ip.c_str(), info.port);
+            if (status != DISCONNECTED) {
+                loop->connection_closed();
+            }
         }
 
         int get_fd(){
@@ -280,22 +627,22 @@ namespace muduo
         }
 
         void set_conn_cb(const conn_func& _cb) {
-            //logging.debug("连接 %s:%d 被设置了连接回调函数: %p", info.ip.c_str(), info.port, _cb);
+            //LOG_DEBUG("连接 %s:%d 被设置了连接回调函数: %p", info.ip.c_str(), info.port, _cb);
             conn_cb = _cb;
         }
 
         void set_msg_cb(const msg_func& _cb) {
-            //logging.debug("连接 %s:%d 被设置了通信回调函数: %p", info.ip.c_str(), info.port, _cb);
+            //LOG_DEBUG("连接 %s:%d 被设置了通信回调函数: %p", info.ip.c_str(), info.port, _cb);
             msg_cb = _cb;
         }
 
         void set_close_cb(const close_func& _cb) {
-            //logging.debug("连接 %s:%d 被设置了断连回调函数: %p", info.ip.c_str(), info.port, _cb);
+            //LOG_DEBUG("连接 %s:%d 被设置了断连回调函数: %p", info.ip.c_str(), info.port, _cb);
             close_cb = _cb;
         }
 
         void set_event_cb(const event_func& _cb) {
-            //logging.debug("连接 %s:%d 被设置了常规事件回调函数: %p", info.ip.c_str(), info.port, _cb);
+            //LOG_DEBUG("连接 %s:%d 被设置了常规事件回调函数: %p", info.ip.c_str(), info.port, _cb);
             event_cb = _cb;
         }
 
@@ -303,6 +650,43 @@ namespace muduo
             server_close_cb = _cb;
         }
 
+        //发送缓冲区的高低水位, 需在 established 之前或在连接所属loop中调用
+        //发送缓冲区增长到 _high 字节时触发 high_water_cb, 之后回落到 _low 字节以下时触发 low_water_cb
+        void set_water_mark(size_t _high, size_t _low) {
+            high_water_mark = _high;
+            low_water_mark = std::min(_low, _high);
+        }
+
+        void set_high_water_cb(const water_func& _cb) {
+            high_water_cb = _cb;
+        }
+
+        void set_low_water_cb(const water_func& _cb) {
+            low_water_cb = _cb;
+        }
+
+        //不小于 _threshold 字节的数据块以 MSG_ZEROCOPY 发送, 内核或套接字不支持时保持普通发送
+        //数据块在收到内核的完成通知之前一直被保留
+        void enable_zerocopy(size_t _threshold) {
+            loop->run_in_loop(std::bind(&Connection::enable_zerocopy_in_loop, this, _threshold));
+        }
+
+        //发送缓冲区是否处于高水位, 任意线程都可以调用
+        bool is_above_high_water() {
+            return above_high_water;
+        }
+
+        //启用边缘触发, 需在 established 之前调用
+        void enable_edge_trigger() {
+            edge_trigger = true;
+        }
+
+        //输入缓冲区改用环形布局, 需在 established 之前调用
+        //消息回调需要通过 Buffer::peek_spans 访问可读数据, 不能假设 get_read_idx() 之后的数据是连续的
+        void enable_ring_buffer() {
+            in_buffer.set_mode(Buffer::RING);
+        }
+
         //连接获取后，给状态进行初始化
         void established() {
             loop->run_in_loop(std::bind(&Connection::established_in_loop, this));
@@ -310,9 +694,23 @@ namespace muduo
 
         //发送数据,数据放到发送缓冲区，启动写事件监控
         void send(const char* _data, size_t _len) {
-            Buffer buf;
-            buf.write(_data, _len);
-            loop->run_in_loop(std::bind(&Connection::send_in_loop, this, std::move(buf)));
+            send(std::string(_data, _len));
+        }
+
+        //发送数据, 直接接管字符串的内存作为一个数据块, 不再拷贝
+        void send(std::string&& _data) {
+            ChainBuffer::Chunk chunk = std::make_shared<const std::string>(std::move(_data));
+            loop->run_in_loop(std::bind(&Connection::send_in_loop, this, std::move(chunk)));
+        }
+
+        //暂停读取, 对端发送的数据留在内核缓冲区中, 由TCP流控让对端减速
+        void stop_read() {
+            loop->run_in_loop(std::bind(&Connection::stop_read_in_loop, this));
+        }
+
+        //恢复读取
+        void start_read() {
+            loop->run_in_loop(std::bind(&Connection::start_read_in_loop, this));
         }
 
         //关闭连接
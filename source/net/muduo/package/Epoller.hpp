@@ -2,120 +2,144 @@
 
 #include "../../../util/Log.hpp"
 #include "Channel.hpp"
+#include "UringPoller.hpp"
 #include <sys/epoll.h>
 #include <cstring>
 #include <vector>
-#include <unordered_map>
 #include <memory>
+#include <algorithm>
 
 namespace muduo
 {
     class Epoller
     {
+    public:
+        //事件监控的实现, 在 EventLoop 构造时选择
+        enum Backend {
+            EPOLL,
+            IO_URING, //内核或头文件不支持时回退到 EPOLL
+        };
+
     private:
-        static const int size = 65535;
+        static const int init_size = 16; //初始的事件数组大小, 一次返回的事件填满数组时翻倍
+        static const int max_size = 65535;
         static const int timeout = -1;
 
         int epoll_fd;
         std::vector<epoll_event> events;
-        std::unordered_map<int, Channel*> channels;
+        std::unique_ptr<UringPoller> uring; //不为空时所有操作转发给 io_uring 后端
 
-    private:
-        bool has_channel(Channel* _channel) {
-            auto it = channels.find(_channel->get_fd());
-            if (it == channels.end()) {
-                return false;
-            }
-            return true;
-        }
     public:
-        Epoller()
-            : epoll_fd(epoll_create(true)), events(size) {
+        Epoller(Backend _backend = EPOLL)
+            : epoll_fd(-1) {
+            if (_backend == IO_URING) {
+                uring.reset(new UringPoller());
+                if (uring->available()) {
+                    return;
+                }
+                LOG_WARNING("io_uring 不可用, 回退到 epoll");
+                uring.reset();
+            }
+            epoll_fd = epoll_create(true);
+            events.resize(init_size);
             if (epoll_fd == -1) {
-                logging.fatal("Epoller 创建失败: %s", strerror(errno));
+                LOG_FATAL("Epoller 创建失败: %s", strerror(errno));
             }
             else {
-                // logging.info("Epoller 创建成功, epoll_fd: %d!", epoll_fd);
+                // LOG_INFO("Epoller 创建成功, epoll_fd: %d!", epoll_fd);
             }
         }
 
         ~Epoller() {
-            logging.info("~Epoller %d 被释放!", epoll_fd);
+            LOG_INFO("~Epoller %d 被释放!", epoll_fd);
             if (epoll_fd >= 0) {
                 close(epoll_fd);
             }
         }
 
         //添加/修改channel
+        //是否已经注册由channel自己记录, epoll_event.data.ptr 直接指向channel, 不再维护 fd->channel 的映射
         void update(Channel* _channel) {
-            bool ret = has_channel(_channel);
-            int fd = _channel->get_fd();
-            if (fcntl(fd, F_GETFD) == -1) {
-                // logging.warning("fd: %d 已经被关闭，跳过 epoll 移除操作", fd);
+            if (uring) {
+                uring->update(_channel);
                 return;
             }
+            int fd = _channel->get_fd();
             epoll_event event;
-            event.data.fd = fd;
+            event.data.ptr = _channel;
             event.events = _channel->get_event();
 
-            if (ret == false) {
-                int n = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
-                if (n == 0) {
-                    channels.emplace(fd, _channel);
+            if (_channel->is_registered() == false) {
+                if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0) {
+                    _channel->set_registered(true);
+                }
+                else {
+                    LOG_ERROR("Epoller::update 添加 fd: %d 失败: %s", fd, strerror(errno));
                 }
             }
             else {
-                int n = epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+                if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event) < 0) {
+                    LOG_ERROR("Epoller::update 修改 fd: %d 失败: %s", fd, strerror(errno));
+                }
             }
         }
 
         //移除channel
+        //描述符总是在channel移除之后才关闭, 未注册的channel直接跳过
         void remove(Channel* _channel) {
-            int fd = _channel->get_fd();
-            if (fcntl(fd, F_GETFD) == -1) {
-                // logging.warning("fd: %d 已经被关闭，跳过 epoll 移除操作", fd);
+            if (uring) {
+                uring->remove(_channel);
                 return;
             }
-            auto it = channels.find(fd);
-            if (it != channels.end()) {
-                channels.erase(it);
+            if (_channel->is_registered() == false) {
+                return;
             }
-            struct epoll_event event;
-            event.data.fd = fd;
-            event.events = _channel->get_event();
-            int n = epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &event);
+            _channel->set_registered(false);
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, _channel->get_fd(), nullptr);
         }
 
         //开始检测IO事件
         //1.调用epoll_wait, 将发生的事件记录在epoller.events中
-        //2.遍历events的fd, 在监控的channel中找到对应的fd, 并将epoller.events中发生的事件设置到revent中
+        //2.通过events中保存的channel指针, 将发生的事件设置到revent中
         //3.把修改过的channel添加到active中, 以供Eventloop执行
         void wait(std::vector<Channel*>& _active, int _timeout = timeout) {
+            if (uring) {
+                uring->wait(_active, _timeout);
+                return;
+            }
             int n = epoll_wait(epoll_fd, events.data(), events.size(), _timeout);
             if (n < 0) {
                 if (errno == EINTR) {
-                    logging.warning("警告: %s", strerror(errno));
+                    LOG_WARNING("警告: %s", strerror(errno));
                     return;
                 }
                 else {
-                    logging.fatal("Epoller::wait 等待错误: %s", strerror(errno));
+                    LOG_FATAL("Epoller::wait 等待错误: %s", strerror(errno));
                     abort();
                 }
             }
             for (int i = 0; i < n; i++) {
-                auto it = channels.find(events[i].data.fd);
-                if (it == channels.end()) {
-                    logging.fatal("Epoller::wait 中等待的事件不存在!");
-                    abort();
-                }
-                it->second->set_event(events[i].events);
-                _active.emplace_back(it->second);
+                Channel* channel = static_cast<Channel*>(events[i].data.ptr);
+                channel->set_event(events[i].events);
+                _active.emplace_back(channel);
+            }
+            if (n == static_cast<int>(events.size()) && events.size() < max_size) {
+                events.resize(std::min<size_t>(events.size() * 2, max_size));
             }
         }
 
+        //通过 io_uring 提交一次发送, epoll 后端返回 false
+        bool send(Channel* _channel, const struct msghdr* _msg, const std::shared_ptr<void>& _hold) {
+            return uring && uring->send(_channel, _msg, _hold);
+        }
+
         int get_epoll_fd()
         {
             return epoll_fd;
         }
+
+        Backend get_backend() {
+            return uring ? IO_URING : EPOLL;
+        }
     };
 }
\ No newline at end of file
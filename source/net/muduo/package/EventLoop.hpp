@@ -1,9 +1,11 @@
 #pragma once
 
-#include <mutex>
+#include <atomic>
 #include <thread>
 #include <sys/eventfd.h>
 #include "Epoller.hpp"
+#include "TaskQueue.hpp"
+#include "BufferPool.hpp"
 #include "TimeWhell.hpp"
 
 namespace muduo
@@ -18,17 +20,25 @@ namespace muduo
         Channel event_channel; //本loop的channel
         Epoller epoller; //描述符监控
         TimerWheel timer_whell; //定时器模块
-        std::vector<task_func> tasks; //任务池
-        std::mutex mtx;
+        BufferPool buffer_pool; //本loop上连接的缓冲区内存池
+        TaskQueue tasks; //任务池, 无锁的多生产者单消费者队列
+        std::atomic<bool> sleeping; //loop是否即将/正在阻塞在epoll_wait中, 只有此时才需要写eventfd唤醒
+
+        //负载统计, 只由本loop线程写入, 其他线程可以随时读取
+        std::atomic<uint64_t> connection_count; //当前挂在本loop上的连接数
+        std::atomic<uint64_t> event_count; //累计处理的IO事件数
+        std::atomic<uint64_t> recent_event_count; //上一个统计周期内处理的IO事件数
+        std::atomic<uint64_t> window_start; //当前统计周期开始的tick, 其他线程读取时据此判断统计是否过期
+        uint64_t window_event_count; //当前统计周期开始时的累计事件数
 
     private:
         static int create_event_fd() {
             int efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
             if (efd < 0) {
-                logging.fatal("EventLoop::create_event_fd event_fd 创建错误!");
+                LOG_FATAL("EventLoop::create_event_fd event_fd 创建错误!");
                 abort();
             }
-            // logging.info("EventFd 创建成功, event_fd: %d!", efd);
+            // LOG_INFO("EventFd 创建成功, event_fd: %d!", efd);
             return efd;
         }
 
@@ -38,16 +48,7 @@ namespace muduo
         }
 
         void execute_all_task() {
-            std::vector<task_func> ready_tasks;
-            //生命周期:准备任务时
-            {
-                std::unique_lock<std::mutex> lock(mtx);
-                tasks.swap(ready_tasks);
-            }
-            for (auto& task : ready_tasks) {
-                // logging.debug("当前执行的任务: %p", task);
-                task();
-            }
+            tasks.run_all();
         }
 
         void read_event_fd() {
@@ -55,11 +56,11 @@ namespace muduo
             int ret = read(event_fd, &res, sizeof(res));
             if (ret < 0) {
                 if (errno = EINTR || errno == EAGAIN) {
-                    logging.warning("警告: %s", strerror(errno));
+                    LOG_WARNING("警告: %s", strerror(errno));
                     return;
                 }
                 else {
-                    logging.fatal("EventLoop::read_event_fd 读取 event_fd: %d 出错!", event_fd);
+                    LOG_FATAL("EventLoop::read_event_fd 读取 event_fd: %d 出错!", event_fd);
                     abort();
                 }
             }
@@ -71,29 +72,49 @@ namespace muduo
             int ret = write(event_fd, &val, sizeof(val));
             if (ret < 0) {
                 if (errno == EINTR) {
-                    logging.warning("警告: %s", strerror(errno));
+                    LOG_WARNING("警告: %s", strerror(errno));
                 }
             }
         }
 
+        //每秒滚动一次统计周期, 供按近期事件数分配连接的策略使用
+        void count_events(size_t _count) {
+            uint64_t total = event_count.load(std::memory_order_relaxed) + _count;
+            event_count.store(total, std::memory_order_relaxed);
+            uint64_t now = timer_whell.now();
+            if (now - window_start.load(std::memory_order_relaxed) >= load_window) {
+                recent_event_count.store(total - window_event_count, std::memory_order_relaxed);
+                window_start.store(now, std::memory_order_relaxed);
+                window_event_count = total;
+            }
+        }
+
     public:
-        EventLoop()
-            : thread_id(std::this_thread::get_id()), event_fd(create_event_fd()), event_channel(event_fd, this), timer_whell(this) {
+        static const uint64_t load_window = 1000; //负载统计周期(毫秒)
+
+        //_backend 选择事件监控的实现, io_uring 不可用时自动回退到 epoll
+        EventLoop(Epoller::Backend _backend = Epoller::EPOLL)
+            : thread_id(std::this_thread::get_id()), event_fd(create_event_fd()), event_channel(event_fd, this), epoller(_backend), timer_whell(this), sleeping(false), connection_count(0), event_count(0), recent_event_count(0), window_start(0), window_event_count(0) {
             event_channel.set_read_cb(std::bind(&EventLoop::read_event_fd, this));
             event_channel.enable_read();
         }
 
         ~EventLoop() {
-            logging.debug("EventLoop被释放: %p", this);
+            LOG_DEBUG("EventLoop被释放: %p", this);
         }
 
         //事件监控->就绪事件处理->执行任务
         //1.获取到有新事件发生的Channel, 执行其中的回调
         //2.执行所有该线程的任务
+        //阻塞前先标记 sleeping 再检查任务池: 要么这里看到了新任务, 要么压入任务的线程看到了 sleeping 并写eventfd
         void start() {
             while (true) {
                 std::vector<Channel*> actives;
-                epoller.wait(actives);
+                sleeping.store(true);
+                epoller.wait(actives, tasks.empty() ? -1 : 0);
+                sleeping.store(false);
+                timer_whell.update_now();
+                count_events(actives.size());
                 for (auto &active : actives)
                 {
                     active->handler_event();
@@ -108,13 +129,12 @@ namespace muduo
 
         //压入任务池
         void push_task(const task_func& _cb) {
-            {
-                std::unique_lock<std::mutex> lock(mtx);
-                tasks.emplace_back(_cb);
-            }
+            tasks.push(_cb);
             //唤醒可能因为没有事件就绪导致的epoll_wait阻塞
-            //给eventfd写入数据，触发其可读事件, 让epoll_wait执行完毕
-            awake_event_fd();
+            //只有loop睡下后的第一个生产者写eventfd, loop醒着时压入的任务会在本轮末尾执行, 不需要系统调用
+            if (sleeping.exchange(false)) {
+                awake_event_fd();
+            }
         }
 
         //判断任务是否处于当前线程中，是则执行，否则压入任务池
@@ -129,11 +149,20 @@ namespace muduo
 
         void assert_in_loop() {
             if (thread_id != std::this_thread::get_id()) {
-                logging.fatal("EventLoop::assert_in_loop 线程执行任务错误!");
+                LOG_FATAL("EventLoop::assert_in_loop 线程执行任务错误!");
                 abort();
             }
         }
 
+        //只能在本loop线程中使用
+        BufferPool* get_buffer_pool() {
+            return &buffer_pool;
+        }
+
+        Epoller::Backend get_backend() {
+            return epoller.get_backend();
+        }
+
         //在epoller中添加/修改channel
         void epoll_update(Channel* _channel) {
             epoller.update(_channel);
@@ -144,7 +173,18 @@ namespace muduo
             epoller.remove(_channel);
         }
 
+        //通过 io_uring 后端提交发送, 在本轮结束时与等待一起交给内核
+        bool ring_send(Channel* _channel, const struct msghdr* _msg, const std::shared_ptr<void>& _hold) {
+            return epoller.send(_channel, _msg, _hold);
+        }
+
+        //_timeout 单位为秒
         void timer_add(uint64_t _timer_id, uint32_t _timeout, const task_func& _task_cb) {
+            timer_whell.add(_timer_id, _timeout * 1000, _task_cb);
+        }
+
+        //_timeout 单位为毫秒, 用于请求超时/重试退避等短定时
+        void timer_add_ms(uint64_t _timer_id, uint32_t _timeout, const task_func& _task_cb) {
             timer_whell.add(_timer_id, _timeout, _task_cb);
         }
 
@@ -155,6 +195,47 @@ namespace muduo
         void timer_cancel(uint64_t _timer_id) {
             timer_whell.cancel(_timer_id);
         }
+
+        //连接建立/释放时调用, 可以在任意线程中调用
+        void connection_opened() {
+            connection_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void connection_closed() {
+            connection_count.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        uint64_t get_connection_count() {
+            return connection_count.load(std::memory_order_relaxed);
+        }
+
+        uint64_t get_event_count() {
+            return event_count.load(std::memory_order_relaxed);
+        }
+
+        //统计周期只在loop醒来时滚动, 空闲的loop会一直保留最后一个周期的计数
+        //距离周期开始已经超过两个周期, 说明这段时间没有任何事件, 按0处理
+        uint64_t get_recent_event_count() {
+            uint64_t start = window_start.load(std::memory_order_relaxed);
+            if (timer_whell.real_now() - start > 2 * load_window) {
+                return 0;
+            }
+            return recent_event_count.load(std::memory_order_relaxed);
+        }
+
+        //本轮事件开始时的毫秒tick, 与定时器使用同一时钟
+        uint64_t now_tick() {
+            return timer_whell.now();
+        }
+
+        //侵入式定时器节点, 只能在loop线程中调用
+        void timer_add_node(TimerTask* _task, uint64_t _expire) {
+            timer_whell.add_node(_task, _expire);
+        }
+
+        void timer_cancel_node(TimerTask* _task) {
+            timer_whell.cancel_node(_task);
+        }
     };
 
     //在eventloop中更新Channel
@@ -164,10 +245,15 @@ namespace muduo
 
     //在eventloop中删除Channel
     void Channel::remove() {
-        // logging.debug("尝试在 eventloop 中删除 fd: %d!", fd);
+        // LOG_DEBUG("尝试在 eventloop 中删除 fd: %d!", fd);
         loop->epoll_remove(this);
     }
 
+    //通过eventloop的 io_uring 后端提交发送
+    bool Channel::submit_send(const struct msghdr* _msg, const std::shared_ptr<void>& _hold) {
+        return loop->ring_send(this, _msg, _hold);
+    }
+
     //添加定时器任务
     void TimerWheel::add(uint64_t _timer_id, uint32_t _timeout, const task_func& _task_cb) {
         loop->run_in_loop(std::bind(&TimerWheel::add_in_loop, this, _timer_id, _timeout, _task_cb));
@@ -3,6 +3,8 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <pthread.h>
+#include <sched.h>
 #include "../package/EventLoop.hpp"
 
 namespace muduo
@@ -11,15 +13,27 @@ namespace muduo
     {
     private:
         EventLoop* loop;
-        std::thread loop_thread;
+        int cpu; //绑定的CPU, -1 表示不绑定
+        Epoller::Backend backend; //事件监控的实现
 
         std::mutex mtx;
         std::condition_variable cond;
         //通过条件变量和互斥锁,实现同步互斥的关系
+        //线程必须在 mtx 和 cond 构造完成之后才能启动, 所以 loop_thread 要声明在它们后面
+        std::thread loop_thread;
     private:
         //实例化 EventLoop 对象，唤醒cond上有可能阻塞的线程，并且开始运行EventLoop模块的功能
         void thread_entry() {
-            EventLoop this_loop;
+            if (cpu >= 0) {
+                cpu_set_t cpu_set;
+                CPU_ZERO(&cpu_set);
+                CPU_SET(cpu, &cpu_set);
+                int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+                if (ret != 0) {
+                    LOG_WARNING("loop线程绑定CPU %d 失败: %s", cpu, strerror(ret));
+                }
+            }
+            EventLoop this_loop(backend);
             {
                 std::unique_lock<std::mutex> lock(mtx);
                 loop = &this_loop;
@@ -28,8 +42,8 @@ namespace muduo
             this_loop.start();
         }
     public:
-        LoopThread()
-            : loop(nullptr), loop_thread(std::thread(&LoopThread::thread_entry, this)) {
+        LoopThread(int _cpu = -1, Epoller::Backend _backend = Epoller::EPOLL)
+            : loop(nullptr), cpu(_cpu), backend(_backend), loop_thread(std::thread(&LoopThread::thread_entry, this)) {
             loop_thread.detach();
         }
 
@@ -38,10 +52,14 @@ namespace muduo
             {
                 std::unique_lock<std::mutex> lock(mtx);
                 cond.wait(lock, [&]() {return loop != nullptr;});
-                logging.debug("loop实例化完成: %p", loop);
+                LOG_DEBUG("loop实例化完成: %p", loop);
                 this_loop = loop;
             }
             return this_loop;
         }
+
+        int get_cpu() {
+            return cpu;
+        }
     };
 }
\ No newline at end of file
@@ -3,39 +3,143 @@
 
 namespace muduo
 {
+    //单个loop的负载快照
+    struct LoopLoad
+    {
+        int index; //在线程池中的下标
+        int cpu; //绑定的CPU, -1 表示未绑定
+        uint64_t connections; //当前连接数
+        uint64_t total_events; //累计处理的IO事件数
+        uint64_t recent_events; //上一个统计周期内处理的IO事件数
+    };
+
     class LoopThreadPool
     {
+    public:
+        //新连接分配到哪个loop
+        enum Policy {
+            ROUND_ROBIN, //轮询
+            LEAST_CONNECTIONS, //当前连接数最少
+            LEAST_EVENTS, //上一个统计周期内事件数最少
+            HASH_PEER, //按对端地址哈希, 同一客户端总落在同一个loop
+        };
+
+        //自定义分配策略, 返回选中的loop下标
+        using select_func = std::function<size_t(const std::vector<LoopLoad>&, size_t)>;
+
     private:
         int thread_count;
         int next_idx;
         EventLoop* base_loop;
         std::vector<LoopThread*> threads;
         std::vector<EventLoop*> loops;
+        Policy policy;
+        select_func select_cb;
+        std::vector<int> cpus; //loop线程依次绑定的CPU
+        Epoller::Backend backend; //loop线程使用的事件监控实现
+
+        size_t least_connections() {
+            size_t best = 0;
+            for (size_t i = 1; i < loops.size(); i++) {
+                if (loops[i]->get_connection_count() < loops[best]->get_connection_count()) {
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        //事件数相同时再比较连接数, 避免空闲时全部落到第一个loop
+        size_t least_events() {
+            size_t best = 0;
+            for (size_t i = 1; i < loops.size(); i++) {
+                uint64_t events = loops[i]->get_recent_event_count();
+                uint64_t best_events = loops[best]->get_recent_event_count();
+                if (events < best_events || (events == best_events && loops[i]->get_connection_count() < loops[best]->get_connection_count())) {
+                    best = i;
+                }
+            }
+            return best;
+        }
+
     public:
         LoopThreadPool(EventLoop* _base_loop)
-            : thread_count(0), next_idx(0), base_loop(_base_loop) {}
+            : thread_count(0), next_idx(0), base_loop(_base_loop), policy(ROUND_ROBIN), backend(_base_loop->get_backend()) {}
 
         void set_thread_count(int count) {
             thread_count = count;
         }
 
+        void set_policy(Policy _policy) {
+            policy = _policy;
+        }
+
+        //设置后优先于 policy 使用
+        void set_select_cb(const select_func& _cb) {
+            select_cb = _cb;
+        }
+
+        //第i个loop线程绑定到 _cpus[i % _cpus.size()], 需在 create 之前调用
+        void set_cpu_affinity(const std::vector<int>& _cpus) {
+            cpus = _cpus;
+        }
+
+        //默认与base_loop相同, 需在 create 之前调用
+        void set_backend(Epoller::Backend _backend) {
+            backend = _backend;
+        }
+
         void create() {
             if (thread_count > 0) {
                 threads.resize(thread_count);
                 loops.resize(thread_count);
                 for (int i = 0; i < thread_count; i++) {
-                    threads[i] = new LoopThread();
+                    int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+                    threads[i] = new LoopThread(cpu, backend);
                     loops[i] = threads[i]->get_loop();
                 }
             }
         }
 
-        EventLoop* next_loop() {
+        //线程池中的所有loop, 没有子线程时只有base_loop
+        std::vector<EventLoop*> get_all_loops() {
+            if (thread_count == 0) {
+                return { base_loop };
+            }
+            return loops;
+        }
+
+        //各个loop的负载快照, 没有子线程时只有base_loop
+        std::vector<LoopLoad> get_loads() {
+            std::vector<LoopLoad> loads;
+            std::vector<EventLoop*> all_loops = get_all_loops();
+            for (size_t i = 0; i < all_loops.size(); i++) {
+                int cpu = threads.empty() ? -1 : threads[i]->get_cpu();
+                loads.push_back({ static_cast<int>(i), cpu, all_loops[i]->get_connection_count(),
+                    all_loops[i]->get_event_count(), all_loops[i]->get_recent_event_count() });
+            }
+            return loads;
+        }
+
+        //_peer_hash 为对端地址的哈希值, 只有 HASH_PEER 和自定义策略使用
+        EventLoop* next_loop(size_t _peer_hash = 0) {
             if (thread_count == 0) {
                 return base_loop;
             }
-            next_idx = (next_idx + 1) % thread_count;
-            return loops[next_idx];
+            if (select_cb) {
+                return loops[select_cb(get_loads(), _peer_hash) % loops.size()];
+            }
+            switch (policy)
+            {
+            case LEAST_CONNECTIONS:
+                return loops[least_connections()];
+            case LEAST_EVENTS:
+                return loops[least_events()];
+            case HASH_PEER:
+                return loops[_peer_hash % loops.size()];
+            default:
+                next_idx = (next_idx + 1) % thread_count;
+                return loops[next_idx];
+            }
         }
     };
-}
\ No newline at end of file
+}
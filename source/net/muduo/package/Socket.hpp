@@ -4,7 +4,12 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <cstring>
+#include <functional>
+#include <linux/errqueue.h>
 
 namespace muduo
 {
@@ -20,6 +25,7 @@ namespace muduo
         enum Protocol {
             IPV4_TCP,
             IPV6_TCP,
+            UNIX_STREAM, //本机 AF_UNIX 流式套接字, ip 写作 "unix:<路径>", 端口不使用
         };
     private:
         struct SocketType {
@@ -40,7 +46,9 @@ namespace muduo
         SocketType socket_type;
         int socket_fd;
 
-        const int back_loging = 10;
+        //全连接队列长度, 连接风暴时过小会直接溢出丢弃连接
+        //Acceptor 在 listen_socket 构造完成之前就调用了 create_server, 这里必须是静态常量, 不能依赖成员初始化
+        static const int back_loging = SOMAXCONN;
     public:
 
         //domain(AF_INET/AF_INET6), type(SOCK_STREAM(TCP)/SOCK_DGRAM(UDP)), 0
@@ -57,18 +65,41 @@ namespace muduo
             case IPV6_TCP:
                 socket_type = SocketType(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
                 break;
+            case UNIX_STREAM:
+                socket_type = SocketType(AF_UNIX, SOCK_STREAM, 0);
+                break;
             
             default:
-                logging.fatal("Socket 协议参数错误!");
+                LOG_FATAL("Socket 协议参数错误!");
                 abort();
             }
         }
 
         ~Socket() {
-            // logging.debug("Socket::~Socket()");
+            // LOG_DEBUG("Socket::~Socket()");
             remove();
         }
         
+        //"unix:/path" 或 "unix://host/path" 形式的地址表示本机的 AF_UNIX 套接字
+        static bool is_unix_address(const std::string& ip) {
+            return ip.compare(0, 5, "unix:") == 0;
+        }
+
+        //取出 unix 地址中的套接字路径, "unix://host/path" 中的主机名只用于服务发现, 这里忽略
+        static std::string unix_path(const std::string& ip) {
+            std::string path = ip.substr(5);
+            if (path.compare(0, 2, "//") == 0) {
+                size_t pos = path.find('/', 2);
+                path = pos == std::string::npos ? std::string() : path.substr(pos);
+            }
+            return path;
+        }
+
+        //根据地址的写法选择协议
+        static Protocol protocol_of(const std::string& ip) {
+            return is_unix_address(ip) ? UNIX_STREAM : IPV4_TCP;
+        }
+
         void create(int domain, int type, int protocol) {
             socket_type.domain = domain;
             socket_type.type = type;
@@ -76,15 +107,15 @@ namespace muduo
             socket_fd = socket(socket_type.domain, socket_type.type, socket_type.protocol);
             if (socket_fd < 0)
             {
-                logging.fatal("Socket::create 创建错误, %s: %d.", strerror(errno), errno);
+                LOG_FATAL("Socket::create 创建错误, %s: %d.", strerror(errno), errno);
                 exit(Error::SocketErr);
             }
-            // logging.info("Socket 创建成功, socket_fd: %d!", socket_fd);
+            // LOG_INFO("Socket 创建成功, socket_fd: %d!", socket_fd);
         }
 
         void remove(){
             if (socket_fd != -1) {
-                // logging.debug("关闭了套接字fd: %d", socket_fd);
+                // LOG_DEBUG("关闭了套接字fd: %d", socket_fd);
                 close(socket_fd);
                 socket_fd = -1;
             }
@@ -102,25 +133,73 @@ namespace muduo
 
                 if (::bind(socket_fd, (sockaddr*)&local, sizeof(local)) < 0)
                 {
-                    logging.fatal("Socket::bind 绑定端口错误, %s: %d.", strerror(errno), errno);
+                    LOG_FATAL("Socket::bind 绑定端口错误, %s: %d.", strerror(errno), errno);
+                    exit(Error::BindErr);
+                }
+                LOG_INFO("Socket 绑定端口成功, port: %d!", port);
+            }
+            else if (socket_type.domain == AF_UNIX)
+            {
+                sockaddr_un local;
+                socklen_t len;
+                if (!fill_unix_addr(ip, local, len)) {
+                    exit(Error::BindErr);
+                }
+                //上次运行残留的套接字文件会让 bind 返回 EADDRINUSE, 只删除套接字类型的文件
+                struct stat st;
+                if (::stat(local.sun_path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+                    ::unlink(local.sun_path);
+                }
+                if (::bind(socket_fd, (sockaddr*)&local, len) < 0)
+                {
+                    LOG_FATAL("Socket::bind 绑定路径 %s 错误, %s: %d.", local.sun_path, strerror(errno), errno);
                     exit(Error::BindErr);
                 }
-                logging.info("Socket 绑定端口成功, port: %d!", port);
+                LOG_INFO("Socket 绑定路径成功, path: %s!", local.sun_path);
+            }
+        }
+
+        //把 unix 地址填入 sockaddr_un, 路径超出 sun_path 长度时返回 false
+        static bool fill_unix_addr(const std::string& ip, sockaddr_un& addr, socklen_t& len) {
+            std::string path = unix_path(ip);
+            memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+                LOG_ERROR("unix 套接字路径为空或过长: %s", ip.c_str());
+                return false;
             }
+            memcpy(addr.sun_path, path.data(), path.size());
+            len = offsetof(sockaddr_un, sun_path) + path.size() + 1;
+            return true;
         }
 
         void listen()
         {
             if (::listen(socket_fd, back_loging) < 0)
             {
-                logging.fatal("Socket::listen 监听错误, %s: %d.", strerror(errno), errno);
+                LOG_FATAL("Socket::listen 监听错误, %s: %d.", strerror(errno), errno);
                 exit(Error::ListenErr);
             }
-            logging.info("Socket 监听成功!");
+            LOG_INFO("Socket 监听成功!");
         }
 
         bool connect(const std::string& ip, const uint16_t& port)
         {
+            if (socket_type.domain == AF_UNIX)
+            {
+                sockaddr_un server;
+                socklen_t len;
+                if (!fill_unix_addr(ip, server, len)) {
+                    return false;
+                }
+                if (::connect(socket_fd, (const sockaddr*)&server, len))
+                {
+                    LOG_WARNING("Socket 连接错误, %s: %d.", strerror(errno), errno);
+                    return false;
+                }
+                LOG_INFO("Socket 与服务器 %s 建立连接成功!", ip.c_str());
+                return true;
+            }
             sockaddr_in server;
             memset(&server, 0, sizeof(server));
             server.sin_family = socket_type.domain;
@@ -129,10 +208,10 @@ namespace muduo
 
             if (::connect(socket_fd, (const sockaddr*)&server, sizeof(server)))
             {
-                logging.warning("Socket 连接错误, %s: %d.", strerror(errno), errno);
+                LOG_WARNING("Socket 连接错误, %s: %d.", strerror(errno), errno);
                 return false;
             }
-            logging.info("Socket 与服务器 %s:%d 建立连接成功!", ip.c_str(), port);
+            LOG_INFO("Socket 与服务器 %s:%d 建立连接成功!", ip.c_str(), port);
             return true;
         }
 
@@ -150,15 +229,21 @@ namespace muduo
             case IPV6_TCP:
                 create(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
                 break;
+            case UNIX_STREAM:
+                create(AF_UNIX, SOCK_STREAM, 0);
+                break;
             
             default:
-                logging.fatal("Socket::create_server 协议参数错误!");
+                LOG_FATAL("Socket::create_server 协议参数错误!");
                 abort();
             }
             if (block_flag) {
                 non_block();
             }
-            reuse_address();
+            //unix 套接字以路径区分, 没有端口重用的概念
+            if (protocol != UNIX_STREAM) {
+                reuse_address();
+            }
             bind(ip, port);
             listen();
         }
@@ -174,8 +259,11 @@ namespace muduo
             case IPV6_TCP:
                 create(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
                 break;
+            case UNIX_STREAM:
+                create(AF_UNIX, SOCK_STREAM, 0);
+                break;
             default:
-                logging.fatal("Socket::create_client 协议参数错误!");
+                LOG_FATAL("Socket::create_client 协议参数错误!");
                 abort();
             }
             return connect(ip, port);
@@ -183,10 +271,12 @@ namespace muduo
 
         //设置套接字选项---开启地址端口重用
         void reuse_address() {
-            logging.debug("开启了地址端口重用");
+            LOG_DEBUG("开启了地址端口重用");
             int opt = 1;
-            setsockopt(socket_fd, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt));
-            //允许快速重启
+            //两个选项要分别设置, 按位或在一起实际上只设置了 SO_REUSEPORT
+            setsockopt(socket_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+            //允许快速重启, 并允许多个监听套接字绑定同一端口, 由内核分发新连接
+            setsockopt(socket_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
         }
         
         //设置套接字阻塞属性-- 设置为非阻塞
@@ -195,22 +285,44 @@ namespace muduo
             fcntl(socket_fd, F_SETFL, flag | O_NONBLOCK);
         }
 
+        //用 accept4 在同一次系统调用中把新连接设置为非阻塞和 CLOEXEC
+        //失败时返回 -1 并保留 errno, 由调用者区分 EAGAIN/EMFILE 等情况
         int accept(std::string& client_ip, uint16_t& client_port)
         {
-            sockaddr_in client;
+            sockaddr_storage client;
             socklen_t size = sizeof(client);
-            int client_fd = ::accept(socket_fd, (sockaddr*)&client, &size);
+            int client_fd = ::accept4(socket_fd, (sockaddr*)&client, &size, SOCK_NONBLOCK | SOCK_CLOEXEC);
             if (client_fd < 0)
             {
-                logging.warning("Socket 建立连接错误, %s: %d.", strerror(errno), errno);
+                //非阻塞的监听套接字上全连接队列已空, 或描述符耗尽, 交给调用者处理
+                if (errno != EAGAIN && errno != EMFILE && errno != ENFILE) {
+                    int err = errno;
+                    LOG_WARNING("Socket 建立连接错误, %s: %d.", strerror(err), err);
+                    errno = err;
+                }
                 return -1;
             }
 
             char ip_str[64];
-            client_port = ntohs(client.sin_port);
-            inet_ntop(socket_type.domain, &client.sin_addr, ip_str, sizeof(ip_str));
-            client_ip = ip_str;
-            logging.info("Socket 与客户端 %s:%d 建立连接成功!", client_ip.c_str(), client_port);
+            if (client.ss_family == AF_UNIX) {
+                //客户端套接字通常没有绑定路径, 对端地址统一记为 "unix:", 连接据此选择协议
+                const sockaddr_un* un = reinterpret_cast<const sockaddr_un*>(&client);
+                client_ip = size > offsetof(sockaddr_un, sun_path) && un->sun_path[0] != '\0' ? std::string("unix:") + un->sun_path : std::string("unix:");
+                client_port = 0;
+            }
+            else if (client.ss_family == AF_INET6) {
+                const sockaddr_in6* in6 = reinterpret_cast<const sockaddr_in6*>(&client);
+                client_port = ntohs(in6->sin6_port);
+                inet_ntop(AF_INET6, &in6->sin6_addr, ip_str, sizeof(ip_str));
+                client_ip = ip_str;
+            }
+            else {
+                const sockaddr_in* in = reinterpret_cast<const sockaddr_in*>(&client);
+                client_port = ntohs(in->sin_port);
+                inet_ntop(AF_INET, &in->sin_addr, ip_str, sizeof(ip_str));
+                client_ip = ip_str;
+            }
+            LOG_INFO("Socket 与客户端 %s:%d 建立连接成功!", client_ip.c_str(), client_port);
             return client_fd;
         }
 
@@ -223,11 +335,11 @@ namespace muduo
                     return 0;
                 }
                 else if (errno == 0) {
-                    // logging.info("Socket_fd: %d, 关闭了连接: %s!", socket_fd, strerror(errno));
+                    // LOG_INFO("Socket_fd: %d, 关闭了连接: %s!", socket_fd, strerror(errno));
                     return -1;
                 }
                 else {
-                    logging.error("Socket_fd: %d, 接收错误: %s!", socket_fd, strerror(errno));
+                    LOG_ERROR("Socket_fd: %d, 接收错误: %s!", socket_fd, strerror(errno));
                     return -1;
                 }
             }
@@ -241,20 +353,145 @@ namespace muduo
             return recv(buf, len, MSG_DONTWAIT);
         }
 
+        //分散读, 一次系统调用把数据读入多块内存
+        //只有一块内存时退化为 recv, 省去内核拷贝 iovec 数组的开销
+        //多块内存时用 recvmsg 而不是 readv, 二者都带 MSG_DONTWAIT, 阻塞模式的套接字读空后也不会卡住loop线程
+        //被信号打断(EINTR)时重试, 返回 0 只表示暂时无数据(EAGAIN), -1 表示对端关闭或出错
+        //边缘触发下调用方见到 0 就不再读取, 把 EINTR 也当作 0 会让剩下的数据一直留在内核缓冲区中
+        ssize_t readv(const struct iovec* iov, int iovcnt) {
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = const_cast<struct iovec*>(iov);
+            msg.msg_iovlen = iovcnt;
+            ssize_t ret;
+            do {
+                if (iovcnt == 1) {
+                    ret = ::recv(socket_fd, iov[0].iov_base, iov[0].iov_len, MSG_DONTWAIT);
+                }
+                else {
+                    ret = ::recvmsg(socket_fd, &msg, MSG_DONTWAIT);
+                }
+            } while (ret < 0 && errno == EINTR);
+            if (ret < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return 0;
+                }
+                LOG_ERROR("Socket_fd: %d, 接收错误: %s!", socket_fd, strerror(errno));
+                return -1;
+            }
+            if (ret == 0) {
+                return -1;
+            }
+            return ret;
+        }
+
+        //聚集写, 一次系统调用把多块内存中的数据发送出去
+        //用 sendmsg 加 MSG_DONTWAIT 而不是 writev, 阻塞模式的套接字在对端不读时也不会卡住loop线程
+        //被信号打断(EINTR)时重试, 返回 0 只表示发送缓冲区已满(EAGAIN), -1 表示出错
+        ssize_t writev(const struct iovec* iov, int iovcnt) {
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = const_cast<struct iovec*>(iov);
+            msg.msg_iovlen = iovcnt;
+            ssize_t ret;
+            do {
+                ret = ::sendmsg(socket_fd, &msg, MSG_DONTWAIT);
+            } while (ret < 0 && errno == EINTR);
+            if (ret < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return 0;
+                }
+                LOG_ERROR("Socket_fd: %d, 发送错误: %s!", socket_fd, strerror(errno));
+                return -1;
+            }
+            return ret;
+        }
+
+        //与 writev 一致, EINTR 时重试, 返回 0 只表示 EAGAIN
         ssize_t send(const void* buf, size_t len, int flag = 0){
-            ssize_t ret = ::send(socket_fd, buf, len, flag);
+            ssize_t ret;
+            do {
+                ret = ::send(socket_fd, buf, len, flag);
+            } while (ret < 0 && errno == EINTR);
             if (ret < 0) {
-                if (errno == EAGAIN || errno == EINTR) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
                     return 0;
                 }
                 else {
-                    logging.error("Socket_fd: %d, 发送错误!", socket_fd);
+                    LOG_ERROR("Socket_fd: %d, 发送错误!", socket_fd);
                     return -1;
                 }
             }
             return ret;
         }
 
+        //开启 SO_ZEROCOPY, 内核或头文件不支持时返回 false
+        bool enable_zerocopy() {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+            int opt = 1;
+            if (setsockopt(socket_fd, SOL_SOCKET, SO_ZEROCOPY, &opt, sizeof(opt)) == 0) {
+                return true;
+            }
+            LOG_WARNING("Socket_fd: %d, 开启 SO_ZEROCOPY 失败: %s!", socket_fd, strerror(errno));
+#endif
+            return false;
+        }
+
+        //零拷贝发送, 返回值与 send 一致
+        //_pinned 表示这次发送是否真的以零拷贝方式提交, 此时数据要保留到收到完成通知为止
+        //锁定内存超出限制(ENOBUFS)时退化为普通发送
+        ssize_t send_zerocopy(const void* buf, size_t len, bool& _pinned) {
+            _pinned = false;
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+            ssize_t ret;
+            do {
+                ret = ::send(socket_fd, buf, len, MSG_ZEROCOPY | MSG_DONTWAIT);
+            } while (ret < 0 && errno == EINTR);
+            if (ret > 0) {
+                _pinned = true;
+                return ret;
+            }
+            if (ret < 0 && errno != ENOBUFS) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return 0;
+                }
+                LOG_ERROR("Socket_fd: %d, 零拷贝发送错误: %s!", socket_fd, strerror(errno));
+                return -1;
+            }
+#endif
+            return send(buf, len, MSG_DONTWAIT);
+        }
+
+        //读取错误队列中的零拷贝完成通知, 每条通知调用一次 _cb(lo, hi, copied)
+        //[lo, hi] 为完成的零拷贝发送的序号区间, copied 表示内核实际上还是做了拷贝(如回环网卡)
+        //返回读取到的通知条数
+        int recv_zerocopy_notify(const std::function<void(uint32_t, uint32_t, bool)>& _cb) {
+            int count = 0;
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+            while (true) {
+                char control[128];
+                struct msghdr msg = {};
+                msg.msg_control = control;
+                msg.msg_controllen = sizeof(control);
+                if (::recvmsg(socket_fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                    break;
+                }
+                for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm)) {
+                    if (!((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) || (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR))) {
+                        continue;
+                    }
+                    struct sock_extended_err* err = reinterpret_cast<struct sock_extended_err*>(CMSG_DATA(cm));
+                    if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                        continue;
+                    }
+                    count++;
+                    _cb(err->ee_info, err->ee_data, err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED);
+                }
+            }
+#endif
+            return count;
+        }
+
         ssize_t non_block_send(void* buf, size_t len) {
             if (len == 0) {
                 return 0;
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+namespace muduo
+{
+    //无锁的多生产者单消费者任务队列
+    //任意线程都可以 push, 只有所属 EventLoop 的线程可以 pop/run
+    //队尾始终保留一个已经取出的哑节点, 生产者只交换 head, 消费者只移动 tail, 二者不会竞争同一个节点
+    class TaskQueue
+    {
+    public:
+        using task_func = std::function<void()>;
+
+    private:
+        struct Node
+        {
+            task_func task;
+            std::atomic<Node*> next;
+
+            Node() : next(nullptr) {}
+            explicit Node(const task_func& _task) : task(_task), next(nullptr) {}
+        };
+
+        std::atomic<Node*> head; //最新压入的节点, 由生产者修改
+        Node* tail; //哑节点, 其 next 为下一个待执行的任务, 只由消费者修改
+
+    public:
+        TaskQueue()
+            : head(new Node()), tail(head.load(std::memory_order_relaxed)) {}
+
+        ~TaskQueue() {
+            task_func task;
+            while (pop(task)) {}
+            delete tail;
+        }
+
+        TaskQueue(const TaskQueue&) = delete;
+        TaskQueue& operator=(const TaskQueue&) = delete;
+
+        void push(const task_func& _task) {
+            Node* node = new Node(_task);
+            Node* prev = head.exchange(node, std::memory_order_seq_cst);
+            //在 exchange 与这一步之间, 消费者看到的是尚未链接完成的队列, 会把它当作非空但暂时取不出
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        //只能由消费者调用, 取出一个任务
+        bool pop(task_func& _task) {
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                return false;
+            }
+            _task = std::move(next->task);
+            delete tail;
+            tail = next;
+            return true;
+        }
+
+        //只能由消费者调用, 包括有生产者正在压入但尚未链接完成的情况
+        bool empty() {
+            return head.load(std::memory_order_seq_cst) == tail;
+        }
+
+        //只能由消费者调用, 执行调用时已经在队列中的任务
+        //执行过程中新压入的任务留到下一轮, 避免不断给自己投递任务的回调饿死IO事件
+        void run_all() {
+            Node* last = head.load(std::memory_order_acquire);
+            task_func task;
+            while (tail != last && pop(task)) {
+                task();
+            }
+        }
+    };
+}
@@ -1,42 +1,38 @@
 #pragma once
 
 #include <cstring>
+#include <ctime>
 #include <sys/timerfd.h>
 #include <memory>
-#include <unordered_set>
+#include <unordered_map>
 #include "../../../util/Log.hpp"
 #include "Channel.hpp"
 
 namespace muduo
 {
     using task_func = std::function<void()>;
-    using release_func = std::function<void()>;
 
+    //定时任务节点, 以侵入式双向链表挂在时间轮的槽上, 插入/摘除都是O(1)
+    //通过 add 添加的节点由时间轮分配和释放; 也可以由调用者内嵌在自己的对象中, 通过 add_node 反复挂上, 不需要任何内存分配
     class TimerTask
     {
     private:
+        friend class TimerWheel;
+
         uint64_t timer_id; //定时器任务对象id
-        uint32_t timeout; //定时任务的超时时间
+        uint32_t timeout; //定时任务的超时时间(毫秒)
+        uint64_t expire; //到期的tick
         task_func task_cb; //任务回调函数
-        release_func release_cb; //删除TimerWheel种保存的定时器对象信息
-        bool valid; //是否有效
+        TimerTask* prev;
+        TimerTask* next;
+        int level; //所在的层, 用于摘除时维护位图
+        size_t slot; //所在的槽
+        bool linked; //是否挂在时间轮上
+        bool owned; //是否由时间轮分配, 执行或取消后由时间轮释放
 
     public:
         TimerTask(uint64_t _timer_id, uint32_t _timeout, const task_func& _task_cb)
-            : timer_id(_timer_id), timeout(_timeout), task_cb(_task_cb), valid(true) {}
-
-        //析构时执行任务
-        ~TimerTask() {
-            if (valid == true) {
-                logging.debug("定时任务id: %lld 被执行!", timer_id);
-                task_cb();
-            }
-            release_cb();
-        }
-
-        void cancel() {
-            valid = false;
-        }
+            : timer_id(_timer_id), timeout(_timeout), expire(0), task_cb(_task_cb), prev(nullptr), next(nullptr), level(0), slot(0), linked(false), owned(false) {}
 
         uint64_t get_timer_id(){
             return timer_id;
@@ -45,123 +41,314 @@ namespace muduo
         uint32_t get_timeout() {
             return timeout;
         }
-
-        //bind了remove_timer, 删除对应TimerWheel内统计的定时器任务
-        void set_release(const release_func& _release_cb) {
-            release_cb = _release_cb;
-        }
     };
 
+    //毫秒精度的多层时间轮
+    //第0层256个槽, 每槽1ms; 第1~4层各64个槽, 每槽分别为 2^8, 2^14, 2^20, 2^26 ms, 总跨度约49天
+    //高层的槽在低层转完一圈时降级(cascade)到低层, 到期的任务总是在第0层被执行
+    //timerfd 以绝对时间重新设置为下一个需要处理的tick, 没有定时任务时不会唤醒loop
     class TimerWheel
     {
     private:
-        using WeakTask = std::weak_ptr<TimerTask>;
-        using SharedTask = std::shared_ptr<TimerTask>;
-
+        static constexpr int level_count = 5;
+        static constexpr int level0_bits = 8;
+        static constexpr int level_bits = 6;
+        static constexpr uint64_t max_delay = (1ull << (level0_bits + level_bits * (level_count - 1))) - 1;
+        static constexpr uint64_t no_tick = UINT64_MAX;
+        static constexpr int expiring_level = -1; //已经从轮子上取下, 即将执行
 
         EventLoop* loop;
         int timer_fd;
         Channel timer_channel;
-        int capacity; //轮盘容量
-        int tick; //秒针，走到哪释放哪
-        std::vector<std::unordered_set<SharedTask>> wheel;
-        std::unordered_map<uint64_t, WeakTask> timers;
+        uint64_t start_ns; //tick 0 对应的单调时钟时间
+        uint64_t current; //下一个待处理的tick
+        uint64_t armed; //timer_fd当前设置的tick
+        uint64_t cached_now; //每轮epoll_wait返回后更新的当前tick, 供热路径读取
+        size_t pending; //挂在时间轮上(含即将执行)的节点数
+        TimerTask* wheel[level_count][1 << level0_bits];
+        uint64_t bitmap[level_count][(1 << level0_bits) / 64]; //非空槽的位图, 用于快速找到下一个到期的槽
+        TimerTask* expiring; //本tick取下待执行的任务
+        std::unordered_map<uint64_t, TimerTask*> timers;
 
     private:
 
-        //创建一个定时器文件描述符, 每秒超时一次(变得可读)
-        //epoll监控该文件描述符, 超时被检测到, 执行对应回调函数
-        //即可完成每秒执行对应的定时任务
+        static uint64_t monotonic_ns() {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+        }
+
+        //创建一个定时器文件描述符, 由 arm 设置为下一个需要处理的时刻
+        //epoll监控该文件描述符, 超时被检测到, 执行到期的定时任务
         static int create_timer_fd() {
-            int timerfd = timerfd_create(CLOCK_MONOTONIC, 0);
+            int timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
             if (timerfd < 0) {
-                logging.fatal("TimeWhell::create_timer_fd timer_fd 创建错误: %s", strerror(errno));
+                LOG_FATAL("TimeWhell::create_timer_fd timer_fd 创建错误: %s", strerror(errno));
                 abort();
             }
-            struct itimerspec itime;
-            itime.it_value.tv_sec = 1;
-            itime.it_value.tv_nsec = 0;//第一次超时时间为1s后
-            itime.it_interval.tv_sec = 1;
-            itime.it_interval.tv_nsec = 0; //第一次超时后，每次超时的间隔时
-            timerfd_settime(timerfd, 0, &itime, NULL);
-            // logging.info("TimerFd 创建成功, timer_fd: %d!", timerfd);
+            // LOG_INFO("TimerFd 创建成功, timer_fd: %d!", timerfd);
             return timerfd;
         }
 
-        uint64_t read_timer_fd() {
+        static int shift(int _level) {
+            return _level == 0 ? 0 : level0_bits + level_bits * (_level - 1);
+        }
+
+        static size_t slot_count(int _level) {
+            return _level == 0 ? (1 << level0_bits) : (1 << level_bits);
+        }
+
+        uint64_t now_tick() {
+            return (monotonic_ns() - start_ns) / 1000000;
+        }
+
+        void read_timer_fd() {
             uint64_t time;
             int ret = read(timer_fd, &time, sizeof(time));
-            if (ret < 0) {
-                logging.fatal("TimerWheel::read_timer_fd 读取timer_fd失败: %s", strerror(errno));
+            if (ret < 0 && errno != EAGAIN && errno != EINTR) {
+                LOG_FATAL("TimerWheel::read_timer_fd 读取timer_fd失败: %s", strerror(errno));
                 abort();
             }
-            return time;
         }
 
-        void add_in_loop(uint64_t _timer_id, uint32_t _timeout, const task_func& _task_cb) {
-            SharedTask task_ptr(new TimerTask(_timer_id, _timeout, _task_cb));
-            task_ptr->set_release(std::bind(&TimerWheel::remove_timer, this, _timer_id));
-            int delay = task_ptr->get_timeout();
-            logging.debug("添加了一个延迟为 %d 的定时任务, 任务id为 %ld!", delay, _timer_id);
-            wheel[(tick + delay) % capacity].emplace(task_ptr);
-            timers[_timer_id] = WeakTask(task_ptr);
+        //把timer_fd设置为在 _tick 到期, no_tick 表示停止
+        void arm(uint64_t _tick) {
+            if (_tick == armed) {
+                return;
+            }
+            armed = _tick;
+            struct itimerspec itime;
+            memset(&itime, 0, sizeof(itime));
+            if (_tick != no_tick) {
+                uint64_t ns = start_ns + _tick * 1000000;
+                itime.it_value.tv_sec = ns / 1000000000;
+                itime.it_value.tv_nsec = ns % 1000000000;
+            }
+            timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &itime, NULL);
         }
 
-        void cancel_in_loop(uint64_t _timer_id) {
-            auto it = timers.find(_timer_id);
-            if (it == timers.end()) {
-                logging.warning("取消定时任务失败,没有找到id: %ld 的定时任务!", _timer_id);
-                return;
+        //按到期时间与 current 的距离挂到对应层的槽上
+        void place(TimerTask* _task) {
+            if (_task->expire < current) {
+                _task->expire = current;
+            }
+            uint64_t delay = _task->expire - current;
+            if (delay > max_delay) {
+                delay = max_delay;
+                _task->expire = current + max_delay;
+            }
+            int level = 0;
+            while (level < level_count - 1 && delay >= (1ull << shift(level + 1))) {
+                level++;
             }
-            SharedTask task_ptr = it->second.lock();
-            if (task_ptr) {
-                task_ptr->cancel();
+            size_t slot = (_task->expire >> shift(level)) & (slot_count(level) - 1);
+            _task->level = level;
+            _task->slot = slot;
+            _task->prev = nullptr;
+            _task->next = wheel[level][slot];
+            if (_task->next) {
+                _task->next->prev = _task;
             }
+            wheel[level][slot] = _task;
+            bitmap[level][slot / 64] |= 1ull << (slot % 64);
         }
 
-        void refresh_in_loop(uint64_t _timer_id) {
-            //通过weakptr构造shared_ptr,添加到轮子中
-            auto it = timers.find(_timer_id);
-            if (it == timers.end()) {
-                logging.warning("刷新定时任务失败,没有找到id: %ld 的定时任务!", _timer_id);
-                return;
+        void link(TimerTask* _task) {
+            place(_task);
+            _task->linked = true;
+            pending++;
+        }
+
+        void unlink(TimerTask* _task) {
+            if (_task->prev) {
+                _task->prev->next = _task->next;
             }
-            SharedTask task_ptr = it->second.lock();
-            int delay = task_ptr->get_timeout();
-            wheel[(tick + delay) % capacity].emplace(task_ptr);
+            else if (_task->level == expiring_level) {
+                expiring = _task->next;
+            }
+            else {
+                wheel[_task->level][_task->slot] = _task->next;
+                if (_task->next == nullptr) {
+                    bitmap[_task->level][_task->slot / 64] &= ~(1ull << (_task->slot % 64));
+                }
+            }
+            if (_task->next) {
+                _task->next->prev = _task->prev;
+            }
+            _task->prev = _task->next = nullptr;
+            _task->linked = false;
+            pending--;
+        }
+
+        //把一个槽整体取下
+        TimerTask* take_slot(int _level, size_t _slot) {
+            TimerTask* list = wheel[_level][_slot];
+            wheel[_level][_slot] = nullptr;
+            bitmap[_level][_slot / 64] &= ~(1ull << (_slot % 64));
+            return list;
         }
 
-        //在timer中删除该任务，因为已经被执行过了
-        void remove_timer(uint64_t _id) {
-            auto it = timers.find(_id);
+        //高层的槽降级, 按剩余时间重新挂到低层
+        void cascade(int _level, size_t _slot) {
+            TimerTask* list = take_slot(_level, _slot);
+            while (list) {
+                TimerTask* next = list->next;
+                place(list);
+                list = next;
+            }
+        }
+
+        bool level_empty(int _level) {
+            for (size_t i = 0; i < (slot_count(_level) + 63) / 64; i++) {
+                if (bitmap[_level][i] != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //从 _start 开始环形查找第一个非空槽, 返回相隔的槽数, 没有返回-1
+        int next_slot_distance(int _level, size_t _start) {
+            size_t count = slot_count(_level);
+            size_t i = _start;
+            while (i < _start + count) {
+                size_t pos = i & (count - 1);
+                uint64_t word = bitmap[_level][pos / 64] >> (pos % 64);
+                if (word != 0) {
+                    return i - _start + __builtin_ctzll(word);
+                }
+                i += 64 - pos % 64;
+            }
+            return -1;
+        }
+
+        //下一个需要处理的tick, 可能是任务到期, 也可能是高层槽降级的时刻
+        uint64_t next_tick() {
+            if (pending == 0) {
+                return no_tick;
+            }
+            uint64_t best = no_tick;
+            int distance = next_slot_distance(0, current & (slot_count(0) - 1));
+            if (distance >= 0) {
+                best = current + distance;
+            }
+            for (int level = 1; level < level_count; level++) {
+                uint64_t granularity = 1ull << shift(level);
+                uint64_t first = (current + granularity - 1) & ~(granularity - 1);
+                distance = next_slot_distance(level, (first >> shift(level)) & (slot_count(level) - 1));
+                if (distance >= 0) {
+                    best = std::min(best, first + distance * granularity);
+                }
+            }
+            return best;
+        }
+
+        //处理 current 到 _now 之间的所有tick
+        void expire_to(uint64_t _now) {
+            while (current <= _now) {
+                size_t index = current & (slot_count(0) - 1);
+                if (index == 0) {
+                    for (int level = 1; level < level_count; level++) {
+                        size_t slot = (current >> shift(level)) & (slot_count(level) - 1);
+                        cascade(level, slot);
+                        if (slot != 0) {
+                            break;
+                        }
+                    }
+                }
+                //第0层为空时, 下一次降级之前都不会有任务到期, 直接跳过
+                if (level_empty(0)) {
+                    current = std::min((current | (slot_count(0) - 1)) + 1, _now + 1);
+                    continue;
+                }
+                current++;
+                //先整体取下再逐个执行, 回调中新加入的任务不会在本tick被执行, 回调中取消的任务也能正确摘除
+                expiring = take_slot(0, index);
+                for (TimerTask* task = expiring; task; task = task->next) {
+                    task->level = expiring_level;
+                }
+                while (expiring) {
+                    TimerTask* task = expiring;
+                    unlink(task);
+                    LOG_DEBUG("定时任务id: %lld 被执行!", task->timer_id);
+                    if (task->owned) {
+                        timers.erase(task->timer_id);
+                        task_func task_cb = std::move(task->task_cb);
+                        delete task;
+                        task_cb();
+                    }
+                    else {
+                        //回调中可能释放节点的持有者, 先拷贝一份再执行
+                        task_func task_cb = task->task_cb;
+                        task_cb();
+                    }
+                }
+            }
+        }
+
+        void add_in_loop(uint64_t _timer_id, uint32_t _timeout, const task_func& _task_cb) {
+            auto it = timers.find(_timer_id);
             if (it != timers.end()) {
+                LOG_WARNING("定时任务id: %ld 已经存在, 替换为新的任务!", _timer_id);
+                unlink(it->second);
+                delete it->second;
                 timers.erase(it);
             }
+            TimerTask* task = new TimerTask(_timer_id, _timeout, _task_cb);
+            task->owned = true;
+            //向上取整到下一个tick, 保证不会提前执行
+            add_node(task, now_tick() + _timeout + 1);
+            timers.emplace(_timer_id, task);
+            LOG_DEBUG("添加了一个延迟为 %u ms 的定时任务, 任务id为 %ld!", _timeout, _timer_id);
         }
 
-        void run_task() {
-            //每秒执行一次
-            tick = (tick + 1) % capacity;
-            if(wheel[tick].size() > 0){
-                logging.debug("当前定时任务tick: %d, 当前定时任务轮盘的size: %d", tick, wheel[tick].size());
+        void cancel_in_loop(uint64_t _timer_id) {
+            auto it = timers.find(_timer_id);
+            if (it == timers.end()) {
+                LOG_WARNING("取消定时任务失败,没有找到id: %ld 的定时任务!", _timer_id);
+                return;
             }
-            wheel[tick].clear(); // 清空指定位置的数组，通过析构函数自动调用任务
+            unlink(it->second);
+            delete it->second;
+            timers.erase(it);
         }
 
-        void on_time() {
-            int time = read_timer_fd();
-            for (int i = 0; i < time; i++) {
-                run_task();
+        void refresh_in_loop(uint64_t _timer_id) {
+            //从原来的槽摘下, 按新的到期时间重新挂上
+            auto it = timers.find(_timer_id);
+            if (it == timers.end()) {
+                LOG_WARNING("刷新定时任务失败,没有找到id: %ld 的定时任务!", _timer_id);
+                return;
             }
+            TimerTask* task = it->second;
+            add_node(task, now_tick() + task->timeout + 1);
+        }
+
+        void on_time() {
+            read_timer_fd();
+            update_now();
+            expire_to(cached_now);
+            armed = no_tick; //timer_fd是一次性的, 触发后已经失效
+            arm(next_tick());
         }
 
     public:
         TimerWheel(EventLoop* _loop)
-            : loop(_loop), timer_fd(create_timer_fd()), timer_channel(timer_fd, _loop), capacity(60), tick(0), wheel(capacity) {
+            : loop(_loop), timer_fd(create_timer_fd()), timer_channel(timer_fd, _loop), start_ns(monotonic_ns()), current(0), armed(no_tick), cached_now(0), pending(0), expiring(nullptr) {
+            memset(wheel, 0, sizeof(wheel));
+            memset(bitmap, 0, sizeof(bitmap));
             timer_channel.set_read_cb(std::bind(&TimerWheel::on_time, this));
             timer_channel.enable_read();
         }
 
+        ~TimerWheel() {
+            for (auto& timer : timers) {
+                delete timer.second;
+            }
+            timer_channel.remove();
+            close(timer_fd);
+        }
+
         bool has_timer(uint64_t _timer_id) {
             auto it = timers.find(_timer_id);
             if (it == timers.end()) {
@@ -172,7 +359,49 @@ namespace muduo
             }
         }
 
-        //添加定时器任务
+        //刷新缓存的当前tick, 由EventLoop在每轮epoll_wait返回后调用
+        void update_now() {
+            cached_now = now_tick();
+        }
+
+        //最近一次 update_now 时的tick, 只是一次内存读取
+        uint64_t now() {
+            return cached_now;
+        }
+
+        //实时读取当前tick, 不依赖 update_now, 任意线程都可以调用
+        uint64_t real_now() {
+            return now_tick();
+        }
+
+        //以下 *_node 接口只能在loop线程中调用
+        //把调用者持有的节点挂到 _expire 这个tick上, 已经挂上的节点会先摘下
+        void add_node(TimerTask* _task, uint64_t _expire) {
+            if (_task->linked) {
+                unlink(_task);
+            }
+            //没有定时任务时轮子不会被推进, 直接对齐到当前时间
+            if (pending == 0) {
+                current = std::max(current, now_tick());
+            }
+            _task->expire = _expire;
+            link(_task);
+            if (_task->expire < armed) {
+                arm(_task->expire);
+            }
+        }
+
+        void cancel_node(TimerTask* _task) {
+            if (_task->linked) {
+                unlink(_task);
+            }
+        }
+
+        bool node_linked(TimerTask* _task) {
+            return _task->linked;
+        }
+
+        //添加定时器任务, _timeout 单位为毫秒
         void add(uint64_t _timer_id, uint32_t _timeout, const task_func& _task_cb);
 
         //取消定时器任务
@@ -0,0 +1,674 @@
+#pragma once
+
+#include "../../../util/Log.hpp"
+#include "Channel.hpp"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+
+//编译时的内核头文件足够新才启用, 否则 UringPoller 总是报告不可用, 由 Epoller 回退到 epoll
+#if defined(IORING_FEAT_EXT_ARG) && defined(IORING_POLL_ADD_MULTI) && defined(__NR_io_uring_setup)
+#define MUDUO_HAS_IO_URING 1
+#endif
+
+//multishot recv 与提供给内核的接收缓冲区环(6.0), 头文件不支持时连接仍然用 poll + 读
+#if defined(MUDUO_HAS_IO_URING) && defined(IORING_RECV_MULTISHOT)
+#define MUDUO_HAS_URING_RECV 1
+#endif
+
+namespace muduo
+{
+    //基于 io_uring 的事件监控, 接口与 Epoller 一致, 保持 Channel 的就绪回调语义不变
+    //1. 每个channel对应一个 IORING_OP_POLL_ADD 请求, 水平触发的channel使用单次poll, 每次完成后重新提交,
+    //   提交时内核会立即检查就绪状态, 与 epoll 的水平触发等价; 边缘触发的channel使用 multishot poll
+    //2. 设置了接收回调的channel(连接)改用 multishot recv, 内核把数据直接收进注册的缓冲区环,
+    //   完成时先把数据交给接收回调, 再照常报告可读事件, poll 只负责可写和错误事件
+    //3. 发送通过 submit_send 写入提交队列; 关心事件的修改也只是标记槽位, 二者都在下一轮 wait 时
+    //   与等待合并为一次 io_uring_enter
+    //4. poll 请求的 user_data 为 槽位下标 + 代数, channel 修改/移除后内核中残留的完成事件会因代数不匹配被丢弃;
+    //   recv/send 请求结束之前槽位不会被复用
+    class UringPoller
+    {
+    private:
+        static const unsigned entries = 1024;
+        static const unsigned recv_buffer_count = 256; //接收缓冲区环的大小, 必须是2的幂
+        static const unsigned recv_buffer_size = 16384;
+        static const uint16_t recv_group = 0;
+        static const uint32_t index_mask = (1u << 30) - 1;
+
+        //user_data 的第30, 31位区分请求的种类
+        enum Kind {
+            POLL_REQ = 0,
+            RECV_REQ = 1,
+            SEND_REQ = 2,
+        };
+
+        struct Slot
+        {
+            Channel* channel = nullptr;
+            uint32_t gen = 0; //poll请求的代数, 每次撤销poll请求后递增
+            uint32_t armed_mask = 0; //内核中poll请求关心的事件
+            bool armed = false; //内核中是否有该槽位的poll请求
+            bool dirty = false; //是否需要在下一次提交时同步内核中的请求
+            bool recv_armed = false; //内核中是否有该槽位的 multishot recv 请求
+            bool recv_cancel = false; //是否已经提交了撤销 recv 的请求
+            bool send_armed = false; //内核中是否有该槽位的发送请求
+            bool send_cancel = false; //是否已经提交了撤销发送的请求
+            bool zombie = false; //channel已经移除, 内核中的请求全部结束后才放回空闲列表
+            uint64_t active_round = 0; //最近一次被加入active的轮次, 用于去重
+            std::shared_ptr<void> send_hold; //发送完成之前保持数据的持有者存活
+        };
+
+        int ring_fd;
+        bool multishot; //内核是否支持 multishot poll, 提交后返回 -EINVAL 时关闭
+        bool ring_recv; //是否用 multishot recv 接收数据
+        std::vector<Slot> slots;
+        std::vector<uint32_t> free_slots;
+        std::vector<uint32_t> dirty_slots;
+        uint64_t round;
+
+#ifdef MUDUO_HAS_IO_URING
+        void* sq_ptr;
+        size_t sq_size;
+        void* cq_ptr;
+        size_t cq_size;
+        io_uring_sqe* sqes;
+        size_t sqes_size;
+        unsigned* sq_head;
+        unsigned* sq_tail;
+        unsigned* sq_mask;
+        unsigned* sq_array;
+        unsigned* cq_head;
+        unsigned* cq_tail;
+        unsigned* cq_mask;
+        io_uring_cqe* cqes;
+        unsigned sq_local_tail; //已经填写但尚未提交的尾部
+        unsigned sq_submitted; //已经交给内核的尾部
+        void* buf_ring; //注册给内核的接收缓冲区环
+        char* recv_buffers; //接收缓冲区环中各个缓冲区的内存
+        uint16_t buf_tail; //接收缓冲区环的尾部, 归还缓冲区后在本轮末尾一次性发布
+
+        static const uint64_t remove_tag = UINT64_MAX; //撤销请求本身的完成事件, 直接忽略
+
+        static uint64_t make_token(uint32_t _index, uint32_t _gen, uint32_t _kind = POLL_REQ) {
+            return (static_cast<uint64_t>(_gen) << 32) | (_kind << 30) | _index;
+        }
+
+        int enter(unsigned _to_submit, unsigned _min_complete, unsigned _flags, void* _arg, size_t _arg_size) {
+            return syscall(__NR_io_uring_enter, ring_fd, _to_submit, _min_complete, _flags, _arg, _arg_size);
+        }
+
+        //把已经填写的请求交给内核, 不等待完成
+        void flush() {
+            unsigned to_submit = sq_local_tail - sq_submitted;
+            if (to_submit == 0) {
+                return;
+            }
+            __atomic_store_n(sq_tail, sq_local_tail, __ATOMIC_RELEASE);
+            sq_submitted = sq_local_tail;
+            if (enter(to_submit, 0, 0, nullptr, 0) < 0 && errno != EINTR && errno != EBUSY) {
+                LOG_ERROR("UringPoller::flush 提交失败: %s", strerror(errno));
+            }
+        }
+
+        io_uring_sqe* get_sqe() {
+            unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+            if (sq_local_tail - head >= entries) {
+                //提交队列已满, 先把积压的请求交给内核
+                flush();
+                head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+                if (sq_local_tail - head >= entries) {
+                    return nullptr;
+                }
+            }
+            unsigned index = sq_local_tail & *sq_mask;
+            io_uring_sqe* sqe = &sqes[index];
+            memset(sqe, 0, sizeof(*sqe));
+            sq_array[index] = index;
+            sq_local_tail++;
+            return sqe;
+        }
+
+        //channel 通过 multishot recv 接收数据时, poll 不再关心可读事件
+        static uint32_t poll_mask(Channel* _channel) {
+            uint32_t mask = _channel->get_event();
+            if (_channel->is_ring_read()) {
+                mask &= ~EPOLLIN;
+            }
+            return mask;
+        }
+
+        //提交队列已满时返回 false, 槽位状态不变
+        bool submit_poll_add(uint32_t _index, uint32_t _mask) {
+            Slot& slot = slots[_index];
+            io_uring_sqe* sqe = get_sqe();
+            if (sqe == nullptr) {
+                return false;
+            }
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = slot.channel->get_fd();
+            sqe->poll32_events = _mask & ~EPOLLET;
+            if (multishot && (_mask & EPOLLET)) {
+                sqe->len = IORING_POLL_ADD_MULTI;
+            }
+            sqe->user_data = make_token(_index, slot.gen);
+            slot.armed = true;
+            slot.armed_mask = _mask;
+            return true;
+        }
+
+        //撤销内核中的poll请求, 并让之后到达的旧完成事件失效
+        //拿不到提交项时返回 false, 请求仍然挂着, 代数也保持不变, 旧的完成事件照常处理
+        bool submit_poll_remove(uint32_t _index) {
+            Slot& slot = slots[_index];
+            io_uring_sqe* sqe = get_sqe();
+            if (sqe == nullptr) {
+                return false;
+            }
+            sqe->opcode = IORING_OP_POLL_REMOVE;
+            sqe->fd = -1;
+            sqe->addr = make_token(_index, slot.gen);
+            sqe->user_data = remove_tag;
+            slot.armed = false;
+            slot.gen++;
+            return true;
+        }
+
+        bool submit_cancel(uint64_t _token) {
+            io_uring_sqe* sqe = get_sqe();
+            if (sqe == nullptr) {
+                return false;
+            }
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = _token;
+            sqe->user_data = remove_tag;
+            return true;
+        }
+
+        bool submit_recv(uint32_t _index) {
+#ifdef MUDUO_HAS_URING_RECV
+            Slot& slot = slots[_index];
+            io_uring_sqe* sqe = get_sqe();
+            if (sqe == nullptr) {
+                return false;
+            }
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = slot.channel->get_fd();
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = recv_group;
+            sqe->user_data = make_token(_index, 0, RECV_REQ);
+            slot.recv_armed = true;
+#else
+            (void)_index;
+#endif
+            return true;
+        }
+
+        void mark_dirty(uint32_t _index) {
+            if (!slots[_index].dirty) {
+                slots[_index].dirty = true;
+                dirty_slots.push_back(_index);
+            }
+        }
+
+        //已经移除的channel的槽位, 内核中没有请求之后才能复用
+        void release_slot(uint32_t _index) {
+            Slot& slot = slots[_index];
+            if (!slot.zombie || slot.armed || slot.recv_armed || slot.send_armed) {
+                return;
+            }
+            slot.zombie = false;
+            slot.recv_cancel = false;
+            slot.send_cancel = false;
+            free_slots.push_back(_index);
+        }
+
+        //让内核中的请求与channel关心的事件一致
+        //提交队列已满时返回 false, 已经提交的部分不会重复, 剩下的留到下一轮
+        bool sync_slot(uint32_t _index) {
+            Slot& slot = slots[_index];
+            Channel* channel = slot.channel;
+            bool want_poll = channel != nullptr && channel->get_event() != 0;
+            bool want_recv = channel != nullptr && channel->is_ring_read() && (channel->get_event() & EPOLLIN);
+            uint32_t mask = want_poll ? poll_mask(channel) : 0;
+            if (slot.armed && (!want_poll || slot.armed_mask != mask) && !submit_poll_remove(_index)) {
+                return false;
+            }
+            if (!slot.armed && want_poll && !submit_poll_add(_index, mask)) {
+                return false;
+            }
+            if (slot.recv_armed && !want_recv && !slot.recv_cancel) {
+                if (!submit_cancel(make_token(_index, 0, RECV_REQ))) {
+                    return false;
+                }
+                slot.recv_cancel = true;
+            }
+            //撤销中的 recv 结束后会再次标记槽位, 那时再重新提交
+            if (!slot.recv_armed && want_recv && !submit_recv(_index)) {
+                return false;
+            }
+            //连接关闭后不再等待发送完成, 数据的持有者在撤销完成时释放
+            if (channel == nullptr && slot.send_armed && !slot.send_cancel) {
+                if (!submit_cancel(make_token(_index, 0, SEND_REQ))) {
+                    return false;
+                }
+                slot.send_cancel = true;
+            }
+            if (channel == nullptr) {
+                release_slot(_index);
+            }
+            return true;
+        }
+
+        //同步所有标记过的槽位, 提交队列满时剩下的槽位保持标记, 下一轮再提交
+        void arm_dirty_slots() {
+            size_t done = 0;
+            for (; done < dirty_slots.size(); done++) {
+                uint32_t index = dirty_slots[done];
+                slots[index].dirty = false;
+                if (!sync_slot(index)) {
+                    LOG_ERROR("UringPoller 提交队列已满, 剩余 %zu 个槽位推迟到下一轮", dirty_slots.size() - done);
+                    break;
+                }
+            }
+            for (size_t i = done; i < dirty_slots.size(); i++) {
+                slots[dirty_slots[i]].dirty = true;
+            }
+            dirty_slots.erase(dirty_slots.begin(), dirty_slots.begin() + done);
+        }
+
+        void add_active(uint32_t _index, uint32_t _events, std::vector<Channel*>& _active) {
+            Slot& slot = slots[_index];
+            Channel* channel = slot.channel;
+            if (slot.active_round == round) {
+                channel->set_event(channel->get_revent() | _events);
+            }
+            else {
+                slot.active_round = round;
+                channel->set_event(_events);
+                _active.emplace_back(channel);
+            }
+        }
+
+        void handle_poll(uint32_t _index, io_uring_cqe* _cqe, std::vector<Channel*>& _active) {
+            Slot& slot = slots[_index];
+            if (slot.gen != static_cast<uint32_t>(_cqe->user_data >> 32)) {
+                return;
+            }
+            if (!(_cqe->flags & IORING_CQE_F_MORE)) {
+                //单次poll已经完成, 或multishot被内核终止, 下一轮重新挂上
+                slot.armed = false;
+                mark_dirty(_index);
+            }
+            if (slot.channel == nullptr) {
+                release_slot(_index);
+                return;
+            }
+            //5.13 之前的内核不认识 IORING_POLL_ADD_MULTI, 之后边缘触发的channel也使用单次poll
+            if (_cqe->res == -EINVAL && multishot && (slot.armed_mask & EPOLLET)) {
+                LOG_WARNING("内核不支持 multishot poll, 边缘触发的channel改用单次poll");
+                multishot = false;
+                return;
+            }
+            if (_cqe->res < 0) {
+                return;
+            }
+            add_active(_index, _cqe->res, _active);
+        }
+
+        //内核把缓冲区里的数据交给channel之后立即归还
+        void handle_recv(uint32_t _index, io_uring_cqe* _cqe, std::vector<Channel*>& _active) {
+#ifdef MUDUO_HAS_URING_RECV
+            Slot& slot = slots[_index];
+            Channel* channel = slot.channel;
+            if (_cqe->flags & IORING_CQE_F_BUFFER) {
+                uint16_t bid = _cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+                if (channel != nullptr && _cqe->res > 0) {
+                    channel->deliver(recv_buffers + bid * recv_buffer_size, _cqe->res);
+                }
+                recycle_buffer(bid);
+            }
+            if (!(_cqe->flags & IORING_CQE_F_MORE)) {
+                slot.recv_armed = false;
+                slot.recv_cancel = false;
+                mark_dirty(_index);
+            }
+            if (channel == nullptr) {
+                release_slot(_index);
+                return;
+            }
+            //缓冲区暂时用完或被撤销, 仍然关心可读事件时下一轮重新提交
+            if (_cqe->res == -ENOBUFS || _cqe->res == -ECANCELED) {
+                return;
+            }
+            //6.0 之前的内核不支持 multishot recv, 之后所有channel改回 poll + 读
+            if (_cqe->res == -EINVAL) {
+                if (ring_recv) {
+                    LOG_WARNING("内核不支持 multishot recv, 连接改用 poll + 读");
+                    ring_recv = false;
+                }
+                channel->set_ring_read(false);
+                return;
+            }
+            if (_cqe->res <= 0) {
+                channel->deliver(nullptr, _cqe->res);
+            }
+            add_active(_index, EPOLLIN, _active);
+#else
+            (void)_index;
+            (void)_cqe;
+            (void)_active;
+#endif
+        }
+
+        void handle_send(uint32_t _index, int _res) {
+            Slot& slot = slots[_index];
+            //回调返回之后才释放持有者, 回调中可能再次提交发送
+            std::shared_ptr<void> hold;
+            hold.swap(slot.send_hold);
+            slot.send_armed = false;
+            slot.send_cancel = false;
+            if (slot.channel == nullptr) {
+                release_slot(_index);
+                return;
+            }
+            slot.channel->send_done(_res);
+        }
+
+#ifdef MUDUO_HAS_URING_RECV
+        void recycle_buffer(uint16_t _bid) {
+            //C++ 中 io_uring_buf_ring::bufs 前的空结构体占1字节, bufs 的偏移量与内核不一致, 直接按 io_uring_buf 数组访问
+            io_uring_buf* buf = static_cast<io_uring_buf*>(buf_ring) + (buf_tail & (recv_buffer_count - 1));
+            buf->addr = reinterpret_cast<uint64_t>(recv_buffers + _bid * recv_buffer_size);
+            buf->len = recv_buffer_size;
+            buf->bid = _bid;
+            buf_tail++;
+        }
+
+        void publish_buffers() {
+            __atomic_store_n(&static_cast<io_uring_buf_ring*>(buf_ring)->tail, buf_tail, __ATOMIC_RELEASE);
+        }
+
+        //注册接收缓冲区环(5.19), 失败时连接仍然用 poll + 读
+        bool setup_recv() {
+            buf_ring = mmap(nullptr, recv_buffer_count * sizeof(io_uring_buf), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+            if (buf_ring == MAP_FAILED) {
+                buf_ring = nullptr;
+                return false;
+            }
+            void* buffers = mmap(nullptr, recv_buffer_count * recv_buffer_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (buffers == MAP_FAILED) {
+                munmap(buf_ring, recv_buffer_count * sizeof(io_uring_buf));
+                buf_ring = nullptr;
+                return false;
+            }
+            recv_buffers = static_cast<char*>(buffers);
+            io_uring_buf_reg reg;
+            memset(&reg, 0, sizeof(reg));
+            reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring);
+            reg.ring_entries = recv_buffer_count;
+            reg.bgid = recv_group;
+            if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+                LOG_INFO("io_uring 注册接收缓冲区失败: %s, 连接使用 poll + 读", strerror(errno));
+                munmap(recv_buffers, recv_buffer_count * recv_buffer_size);
+                munmap(buf_ring, recv_buffer_count * sizeof(io_uring_buf));
+                recv_buffers = nullptr;
+                buf_ring = nullptr;
+                return false;
+            }
+            for (unsigned i = 0; i < recv_buffer_count; i++) {
+                recycle_buffer(i);
+            }
+            publish_buffers();
+            return true;
+        }
+#endif
+
+        bool setup() {
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            ring_fd = syscall(__NR_io_uring_setup, entries, &params);
+            if (ring_fd < 0) {
+                LOG_WARNING("io_uring_setup 失败: %s", strerror(errno));
+                return false;
+            }
+            //等待超时依赖 EXT_ARG(5.11), 完成队列溢出依赖 NODROP
+            if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_NODROP) || !(params.features & IORING_FEAT_SINGLE_MMAP)) {
+                LOG_WARNING("内核的 io_uring 功能不足");
+                close(ring_fd);
+                ring_fd = -1;
+                return false;
+            }
+            //multishot poll(5.13) 没有特性位可查, 先假定支持, 内核拒绝时在 handle_poll 中关闭
+            multishot = true;
+
+            sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            sq_size = cq_size = std::max(sq_size, cq_size);
+            sq_ptr = mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+            if (sq_ptr == MAP_FAILED) {
+                LOG_WARNING("io_uring 映射提交队列失败: %s", strerror(errno));
+                close(ring_fd);
+                ring_fd = -1;
+                return false;
+            }
+            cq_ptr = sq_ptr;
+            sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES));
+            if (sqes == MAP_FAILED) {
+                LOG_WARNING("io_uring 映射提交项失败: %s", strerror(errno));
+                munmap(sq_ptr, sq_size);
+                close(ring_fd);
+                ring_fd = -1;
+                return false;
+            }
+            char* sq = static_cast<char*>(sq_ptr);
+            sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            char* cq = static_cast<char*>(cq_ptr);
+            cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            sq_local_tail = sq_submitted = *sq_tail;
+#ifdef MUDUO_HAS_URING_RECV
+            ring_recv = setup_recv();
+#endif
+            return true;
+        }
+#endif
+
+    public:
+        UringPoller()
+            : ring_fd(-1), multishot(false), ring_recv(false), round(0) {
+#ifdef MUDUO_HAS_IO_URING
+            buf_ring = nullptr;
+            recv_buffers = nullptr;
+            buf_tail = 0;
+            if (!setup()) {
+                ring_fd = -1;
+            }
+#endif
+        }
+
+        ~UringPoller() {
+#ifdef MUDUO_HAS_IO_URING
+            if (ring_fd >= 0) {
+                munmap(sqes, sqes_size);
+                munmap(sq_ptr, sq_size);
+                close(ring_fd);
+            }
+#ifdef MUDUO_HAS_URING_RECV
+            if (buf_ring != nullptr) {
+                munmap(recv_buffers, recv_buffer_count * recv_buffer_size);
+                munmap(buf_ring, recv_buffer_count * sizeof(io_uring_buf));
+            }
+#endif
+#endif
+        }
+
+        //当前内核是否可以使用
+        bool available() {
+            return ring_fd >= 0;
+        }
+
+        //添加/修改channel, 只是标记槽位, 在下一次 wait 时统一提交
+        void update(Channel* _channel) {
+#ifdef MUDUO_HAS_IO_URING
+            uint32_t index;
+            if (_channel->is_registered() == false) {
+                if (free_slots.empty()) {
+                    free_slots.push_back(slots.size());
+                    slots.emplace_back();
+                }
+                index = free_slots.back();
+                free_slots.pop_back();
+                slots[index].channel = _channel;
+                _channel->set_backend_index(index);
+                _channel->set_registered(true);
+                _channel->set_ring_read(ring_recv && _channel->has_recv_cb());
+            }
+            else {
+                index = _channel->get_backend_index();
+            }
+            mark_dirty(index);
+#endif
+        }
+
+        //移除channel, 内核中该槽位的请求在下一次 wait 时撤销, 全部结束后槽位才会被复用
+        void remove(Channel* _channel) {
+#ifdef MUDUO_HAS_IO_URING
+            if (_channel->is_registered() == false) {
+                return;
+            }
+            uint32_t index = _channel->get_backend_index();
+            slots[index].channel = nullptr;
+            slots[index].zombie = true;
+            mark_dirty(index);
+            _channel->set_registered(false);
+#endif
+        }
+
+        //提交一次发送, 与下一次 wait 合并为一次 io_uring_enter
+        //每个channel同时只能有一个发送在途, 完成后调用channel的 send_done
+        bool send(Channel* _channel, const struct msghdr* _msg, const std::shared_ptr<void>& _hold) {
+#ifdef MUDUO_HAS_IO_URING
+            if (_channel->is_registered() == false) {
+                return false;
+            }
+            uint32_t index = _channel->get_backend_index();
+            Slot& slot = slots[index];
+            if (slot.send_armed) {
+                return false;
+            }
+            io_uring_sqe* sqe = get_sqe();
+            if (sqe == nullptr) {
+                return false;
+            }
+            if (_msg->msg_iovlen == 1) {
+                sqe->opcode = IORING_OP_SEND;
+                sqe->addr = reinterpret_cast<uint64_t>(_msg->msg_iov[0].iov_base);
+                sqe->len = _msg->msg_iov[0].iov_len;
+            }
+            else {
+                sqe->opcode = IORING_OP_SENDMSG;
+                sqe->addr = reinterpret_cast<uint64_t>(_msg);
+                sqe->len = 1;
+            }
+            sqe->fd = _channel->get_fd();
+            sqe->msg_flags = MSG_NOSIGNAL;
+            sqe->user_data = make_token(index, 0, SEND_REQ);
+            slot.send_armed = true;
+            slot.send_hold = _hold;
+            return true;
+#else
+            (void)_channel;
+            (void)_msg;
+            (void)_hold;
+            return false;
+#endif
+        }
+
+        //提交积压的请求并等待完成事件, 一次 io_uring_enter 完成两件事
+        void wait(std::vector<Channel*>& _active, int _timeout) {
+#ifdef MUDUO_HAS_IO_URING
+            arm_dirty_slots();
+            unsigned to_submit = sq_local_tail - sq_submitted;
+            __atomic_store_n(sq_tail, sq_local_tail, __ATOMIC_RELEASE);
+            sq_submitted = sq_local_tail;
+
+            bool has_cqe = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE) != *cq_head;
+            unsigned flags = 0;
+            unsigned min_complete = 0;
+            io_uring_getevents_arg arg;
+            struct __kernel_timespec ts;
+            memset(&arg, 0, sizeof(arg));
+            if (!has_cqe && _timeout != 0) {
+                flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+                min_complete = 1;
+                if (_timeout > 0) {
+                    ts.tv_sec = _timeout / 1000;
+                    ts.tv_nsec = (_timeout % 1000) * 1000000LL;
+                    arg.ts = reinterpret_cast<uint64_t>(&ts);
+                }
+            }
+            if (to_submit > 0 || flags != 0) {
+                int ret = enter(to_submit, min_complete, flags, flags ? &arg : nullptr, flags ? sizeof(arg) : 0);
+                if (ret < 0 && errno != EINTR && errno != ETIME && errno != EBUSY) {
+                    LOG_FATAL("UringPoller::wait 等待错误: %s", strerror(errno));
+                    abort();
+                }
+            }
+
+            round++;
+            uint16_t recycled = buf_tail;
+            unsigned head = *cq_head;
+            unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != tail; head++) {
+                io_uring_cqe* cqe = &cqes[head & *cq_mask];
+                if (cqe->user_data == remove_tag) {
+                    continue;
+                }
+                uint32_t index = static_cast<uint32_t>(cqe->user_data) & index_mask;
+                uint32_t kind = static_cast<uint32_t>(cqe->user_data) >> 30;
+                if (index >= slots.size()) {
+                    continue;
+                }
+                if (kind == RECV_REQ) {
+                    handle_recv(index, cqe, _active);
+                }
+                else if (kind == SEND_REQ) {
+                    handle_send(index, cqe->res);
+                }
+                else {
+                    handle_poll(index, cqe, _active);
+                }
+            }
+            __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+#ifdef MUDUO_HAS_URING_RECV
+            if (buf_tail != recycled) {
+                publish_buffers();
+            }
+#else
+            (void)recycled;
+#endif
+#endif
+        }
+    };
+}
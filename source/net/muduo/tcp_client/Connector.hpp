@@ -38,7 +38,7 @@ namespace muduo {
 
         ~Connector() {
             if(channel) {
-                logging.fatal("~Connector channel 未知错误");
+                LOG_FATAL("~Connector channel 未知错误");
                 abort();
             }
         }
@@ -76,14 +76,14 @@ namespace muduo {
         void start_in_loop() {
             loop->assert_in_loop();
             if (state != DISCONNECTED) {
-                logging.fatal("Connector::start_in_loop 状态错误: %d", state);
+                LOG_FATAL("Connector::start_in_loop 状态错误: %d", state);
             }
 
             if (is_connect) {
                 connect();
             }
             else {
-                logging.info("未开启连接");
+                LOG_INFO("未开启连接");
             }
         }
 
@@ -95,21 +95,43 @@ namespace muduo {
             }
         }
 
+        //server_ip 写作 "unix:<路径>" 时连接本机的 unix 套接字, 否则按 IPv4 地址连接
+        //返回发起连接的套接字, _err 为 connect 的错误码
+        int start_connect(int& _err) {
+            int ret;
+            int socket_fd;
+            if (Socket::is_unix_address(server_ip)) {
+                socket_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                sockaddr_un addr;
+                socklen_t len;
+                if (!Socket::fill_unix_addr(server_ip, addr, len)) {
+                    _err = EFAULT;
+                    return socket_fd;
+                }
+                ret = ::connect(socket_fd, reinterpret_cast<sockaddr*>(&addr), len);
+            }
+            else {
+                socket_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                sockaddr_in addr{};
+                addr.sin_family = AF_INET;
+                addr.sin_port = htons(server_port);
+                inet_pton(AF_INET, server_ip.c_str(), &addr.sin_addr);
+                ret = ::connect(socket_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+            }
+            _err = ret == 0 ? 0 : errno;
+            return socket_fd;
+        }
+
         void connect() {
-            int socket_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
-
-            sockaddr_in addr{};
-            addr.sin_family = AF_INET;
-            addr.sin_port = htons(server_port);
-            inet_pton(AF_INET, server_ip.c_str(), &addr.sin_addr);
-            int ret = ::connect(socket_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
-            int err = ret == 0 ? 0 : errno;
+            int err = 0;
+            int socket_fd = start_connect(err);
             switch (err)//错误处理
             {
                 case 0: case EINPROGRESS: case EINTR: case EISCONN:
                 connecting(socket_fd);
                 break;
-                case EAGAIN: case EADDRINUSE: case EADDRNOTAVAIL: case ECONNREFUSED: case ENETUNREACH:
+                //ENOENT: 服务端还没有创建 unix 套接字文件
+                case EAGAIN: case EADDRINUSE: case EADDRNOTAVAIL: case ECONNREFUSED: case ENETUNREACH: case ENOENT:
                 retry(socket_fd);
                 break;
                 case EACCES: case EPERM: case EAFNOSUPPORT: case EALREADY: case EBADF: case EFAULT: case ENOTSOCK:
@@ -124,7 +146,7 @@ namespace muduo {
         void connecting(int socket_fd) {
             state = CONNECTING;
             if(channel) {
-                logging.fatal("Connector::connecting channel 未知错误");
+                LOG_FATAL("Connector::connecting channel 未知错误");
                 abort();
             }
             channel.reset(new Channel(socket_fd, loop));
@@ -135,7 +157,7 @@ namespace muduo {
 
         void handle_write() {
             if (state != CONNECTING) {
-                logging.fatal("Connector::handle_writes 状态错误: %d", state);
+                LOG_FATAL("Connector::handle_writes 状态错误: %d", state);
                 abort();
             }
             channel->disable_all();
@@ -144,12 +166,12 @@ namespace muduo {
             int err = 0;
             socklen_t len = sizeof(err);
             if (::getsockopt(socket_fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
-                logging.error("获取 socket 选项错误: %s", strerror(errno));
+                LOG_ERROR("获取 socket 选项错误: %s", strerror(errno));
                 err = errno;
             }
 
             if (err || is_self_connect(socket_fd)) {
-                logging.warning("连接失败: %s", strerror(err));
+                LOG_WARNING("连接失败: %s", strerror(err));
                 retry(socket_fd);
             }
             else {
@@ -158,7 +180,7 @@ namespace muduo {
                     new_conn_cb(socket_fd);
                 }
                 else {
-                    logging.info("未开启连接");
+                    LOG_INFO("未开启连接");
                     // 关闭socket
                     ::close(socket_fd);
                 }
@@ -171,15 +193,19 @@ namespace muduo {
                 int err = 0;
                 socklen_t len = sizeof(err);
                 if (::getsockopt(socket_fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
-                    logging.error("获取 socket 选项错误: %s", strerror(errno));
+                    LOG_ERROR("获取 socket 选项错误: %s", strerror(errno));
                     err = errno;
                 }
-                logging.warning("连接失败: %s", strerror(err));
+                LOG_WARNING("连接失败: %s", strerror(err));
                 retry(socket_fd);
             }
         }
 
+        //只有 TCP 的临时端口会与目标端口撞上, unix 套接字不会自连接
         bool is_self_connect(int sockfd) {
+            if (Socket::is_unix_address(server_ip)) {
+                return false;
+            }
             sockaddr_in local, peer;
             socklen_t len = sizeof(local);
             if (::getsockname(sockfd, (sockaddr*)&local, &len) < 0) return false;
@@ -192,14 +218,16 @@ namespace muduo {
             ::close(socket_fd);
             state = DISCONNECTED;
             if (is_connect) {
-                logging.info("将在 %ds 后重试连接 %s:%d",
+                LOG_INFO("将在 %ds 后重试连接 %s:%d",
                             retry_delay, server_ip.c_str(), server_port);
                 loop->timer_add(timer_id, retry_delay, std::bind(&Connector::start_in_loop, shared_from_this()));
                 retry_delay = std::min(retry_delay * 2, max_retry_delay);
             }
         }
 
+        //描述符交给调用者之前先移除监控, io_uring 的poll请求会持有描述符, 不能依赖 close 自动移除
         int reset_channel() {
+            channel->remove();
             int socket_fd = channel->get_fd();
             loop->push_task(std::bind(&Connector::reset_channel_in_loop, shared_from_this()));
             return socket_fd;
@@ -16,6 +16,8 @@ namespace muduo {
         uint16_t server_port;
         bool retry;
         bool is_connected;
+        bool edge_trigger; //连接是否使用边缘触发
+        bool ring_buffer; //输入缓冲区是否使用环形布局
         std::mutex mtx;
         Connection::ptr conn;
         conn_func conn_cb;
@@ -24,18 +26,21 @@ namespace muduo {
 
     public:
 
+        //_ip 写作 "unix:<路径>" 时连接本机的 unix 套接字, _port 不使用
         TcpClient(EventLoop* _loop, const std::string& _ip, uint16_t _port)
             : loop(_loop)
             ,  connector(new Connector(_loop, _ip, _port))
             ,  server_ip(_ip)
             ,  server_port(_port)
             ,  retry(false)
-            ,  is_connected(true) {
+            ,  is_connected(true)
+            ,  edge_trigger(false)
+            ,  ring_buffer(false) {
             connector->set_new_conn_cb(std::bind(&TcpClient::new_connection, this, std::placeholders::_1));
         }
 
         ~TcpClient() {
-            // logging.debug("TcpClient::~TcpClient()");
+            // LOG_DEBUG("TcpClient::~TcpClient()");
             if(is_connected) {
                 disconnect();
             }
@@ -64,6 +69,16 @@ namespace muduo {
             retry = true;
         }
 
+        //需在 connect 之前调用
+        void enable_edge_trigger() {
+            edge_trigger = true;
+        }
+
+        //需在 connect 之前调用
+        void enable_ring_buffer() {
+            ring_buffer = true;
+        }
+
         void set_conn_cb(const conn_func& cb) {
             conn_cb = cb;
         }
@@ -94,6 +109,12 @@ namespace muduo {
             new_conn->set_conn_cb(conn_cb);
             new_conn->set_msg_cb(msg_cb);
             new_conn->set_close_cb(close_cb);
+            if (edge_trigger) {
+                new_conn->enable_edge_trigger();
+            }
+            if (ring_buffer) {
+                new_conn->enable_ring_buffer();
+            }
             {
                 std::lock_guard<std::mutex> lock(mtx);
                 conn = new_conn;
@@ -4,6 +4,7 @@
 #include "../package/Connection.hpp"
 #include "../package/EventLoop.hpp"
 #include "../package/Channel.hpp"
+#include <fcntl.h>
 
 namespace muduo
 {
@@ -20,39 +21,105 @@ namespace muduo
         Channel listen_channel; //监听套接字事件管理
 
         acceptor_func accept_cb; //监听读事件回调函数
+        int accept_batch; //一次可读事件中最多accept的连接数
+        int idle_fd; //预留的描述符, 描述符耗尽时用它腾出位置来接受并关闭连接
+
     private:
-        void handle_read() {
+        static int open_idle_fd() {
+            return ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        }
+
+        bool accept_one() {
             std::string ip;
             uint16_t port;
             int newfd = listen_socket.accept(ip, port);
             if (newfd < 0) {
-                logging.error("监听套接字与客户端建立连接时,发生错误!");
-                return;
+                return false;
             }
             Connection::Info info = { newfd, ip, port };
             if (accept_cb) {
                 accept_cb(info);
             }
+            return true;
         }
 
+        //描述符耗尽时连接会一直留在全连接队列中, 水平触发下监听套接字会不停就绪
+        //释放预留的描述符, 接受这个连接后立即关闭, 让客户端尽快得知失败而不是一直等待
+        void handle_fd_exhausted() {
+            LOG_ERROR("监听套接字:%d, 描述符已耗尽, 拒绝新连接: %s", listen_socket.get_fd(), strerror(errno));
+            if (idle_fd < 0) {
+                return;
+            }
+            ::close(idle_fd);
+            int fd = ::accept(listen_socket.get_fd(), nullptr, nullptr);
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            idle_fd = open_idle_fd();
+        }
+
+        //循环accept直到全连接队列为空或达到批量上限, 连接风暴时减少epoll唤醒次数
+        void handle_read() {
+            for (int i = 0; i < accept_batch; i++) {
+                if (accept_one()) {
+                    continue;
+                }
+                if (errno == EAGAIN) {
+                    break;
+                }
+                if (errno == EMFILE || errno == ENFILE) {
+                    handle_fd_exhausted();
+                    break;
+                }
+                //连接在accept之前已被对端重置, 或被信号打断, 继续处理下一个
+                if (errno == ECONNABORTED || errno == EINTR) {
+                    continue;
+                }
+                LOG_ERROR("监听套接字与客户端建立连接时,发生错误: %s", strerror(errno));
+                break;
+            }
+        }
+
+        //监听套接字设置为非阻塞, 才能循环accept到EAGAIN
+        //ip 写作 "unix:<路径>" 时监听本机的 unix 套接字, 端口不使用
         Socket& create_server(uint16_t port, const std::string& ip) {
-            listen_socket.create_server(Socket::IPV4_TCP, ip, port);
+            listen_socket.create_server(Socket::protocol_of(ip), ip, port, true);
             return listen_socket;
         }
 
     public:
         Acceptor(EventLoop* loop, int port, const std::string& ip)
-            : loop(loop), listen_socket(create_server(port, ip)), listen_channel(listen_socket.get_fd(), loop) {
+            : loop(loop), listen_socket(create_server(port, ip)), listen_channel(listen_socket.get_fd(), loop), accept_batch(64), idle_fd(open_idle_fd()) {
             listen_channel.set_read_cb(std::bind(&Acceptor::handle_read, this));
         }
 
+        ~Acceptor() {
+            if (idle_fd >= 0) {
+                ::close(idle_fd);
+            }
+        }
+
+        void set_accept_batch(int _batch) {
+            accept_batch = _batch > 0 ? _batch : 1;
+        }
+
         void set_accept_cb(const acceptor_func& cb) {
             accept_cb = cb;
         }
 
         void listen() {
-            logging.debug("监听套接字:%d, 启动了可读状态!", listen_socket.get_fd());
+            LOG_DEBUG("监听套接字:%d, 启动了可读状态!", listen_socket.get_fd());
             listen_channel.enable_read();
         }
+
+        //停止监听: 先取走已经在全连接队列中的连接, 再关闭监听套接字
+        //需在所属loop的线程中调用
+        void stop() {
+            LOG_DEBUG("监听套接字:%d, 停止监听!", listen_socket.get_fd());
+            listen_channel.disable_all();
+            listen_channel.remove();
+            while (accept_one()) {}
+            listen_socket.remove();
+        }
     };
 }
\ No newline at end of file
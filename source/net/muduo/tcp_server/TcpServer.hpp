@@ -11,12 +11,20 @@ namespace muduo
     {
     private:
         uint16_t port;
-        uint64_t id; //自增的连接ID
+        std::string ip;
+        std::atomic<uint64_t> id; //自增的连接ID, 多监听模式下由各个loop线程分配
         int timeout; //非活跃连接统计时间
         bool inactive_release; //是否启用非活跃连接销毁
+        bool edge_trigger; //新连接是否使用边缘触发
+        bool ring_buffer; //新连接的输入缓冲区是否使用环形布局
+        size_t zerocopy_threshold; //新连接以零拷贝发送的数据块大小下限, 0 表示不使用
+        bool reuse_port; //每个loop线程各自监听同一端口
+        int accept_batch; //一次可读事件中最多accept的连接数
         EventLoop base_loop; //主线程的EventLoop,负责监听事件的处理
         Acceptor acceptor; //监听套接字的管理对象
         LoopThreadPool loop_pool; //EventLoop线程池
+        std::vector<std::unique_ptr<Acceptor>> loop_acceptors; //多监听模式下每个loop线程的监听套接字
+        std::vector<std::unique_ptr<Acceptor>> extra_acceptors; //add_listen 添加的其他监听地址, 由base_loop accept
         std::unordered_map<uint64_t, Connection::ptr> connections;
 
         Connection::conn_func conn_cb;
@@ -26,8 +34,14 @@ namespace muduo
 
     private:
         void new_connection(const Connection::Info& info) {
-            id++;
-            Connection::ptr conn = std::make_shared<Connection>(loop_pool.next_loop(), id, info);
+            new_connection_on(loop_pool.next_loop(std::hash<std::string>()(info.ip)), info);
+        }
+
+        //在 _loop 上建立新连接, 可能在base_loop之外的线程中调用
+        //connections 只在base_loop中修改, 先投递加入再投递就绪, 保证移除总在加入之后
+        void new_connection_on(EventLoop* _loop, const Connection::Info& info) {
+            uint64_t conn_id = ++id;
+            Connection::ptr conn = std::make_shared<Connection>(_loop, conn_id, info);
             conn->set_conn_cb(conn_cb);
             conn->set_msg_cb(msg_cb);
             conn->set_close_cb(close_cb);
@@ -36,19 +50,32 @@ namespace muduo
             if (inactive_release == true) {
                 conn->enable_inactive_release(timeout);
             }
+            if (edge_trigger == true) {
+                conn->enable_edge_trigger();
+            }
+            if (ring_buffer == true) {
+                conn->enable_ring_buffer();
+            }
+            if (zerocopy_threshold > 0) {
+                conn->enable_zerocopy(zerocopy_threshold);
+            }
+            base_loop.run_in_loop(std::bind(&TcpServer::add_connection_in_loop, this, conn));
             conn->established();//就绪初始化
-            connections.emplace(id, conn);
+        }
+
+        void add_connection_in_loop(const Connection::ptr& _conn) {
+            connections.emplace(_conn->get_id(), _conn);
         }
 
         void remove_connection_in_loop(const Connection::ptr& _conn) {
             uint64_t remove_id = _conn->get_id();
             auto it = connections.find(remove_id);
             if (it != connections.end()) {
-                logging.debug("在TcpServer中移除了fd: %d 的连接.", _conn->get_fd());
+                LOG_DEBUG("在TcpServer中移除了fd: %d 的连接.", _conn->get_fd());
                 connections.erase(remove_id);
             }
             else {
-                logging.warning("移除的连接不存在!");
+                LOG_WARNING("移除的连接不存在!");
             }
         }
 
@@ -57,19 +84,32 @@ namespace muduo
         }
 
         void run_after_in_loop(const task_func& _task, int _delay) {
-            id++;
-            base_loop.timer_add(id, _delay, _task);
+            base_loop.timer_add(++id, _delay, _task);
+        }
+
+        //每个loop线程创建自己的监听套接字, 全部加入同一个 SO_REUSEPORT 组后再关闭base_loop上的监听
+        void start_loop_acceptors() {
+            for (EventLoop* loop : loop_pool.get_all_loops()) {
+                Acceptor* loop_acceptor = new Acceptor(loop, port, ip);
+                loop_acceptor->set_accept_batch(accept_batch);
+                loop_acceptor->set_accept_cb(std::bind(&TcpServer::new_connection_on, this, loop, std::placeholders::_1));
+                loop->run_in_loop(std::bind(&Acceptor::listen, loop_acceptor));
+                loop_acceptors.emplace_back(loop_acceptor);
+            }
+            acceptor.stop();
         }
 
     public:
-        TcpServer(uint16_t _port, const std::string& _ip = "0.0.0.0")
-            : port(_port), id(0), inactive_release(false), acceptor(&base_loop, _port, _ip), loop_pool(&base_loop) {
+        //_backend 为所有loop的事件监控实现, 子线程的loop与base_loop保持一致
+        //_ip 写作 "unix:<路径>" 时监听本机的 unix 套接字, _port 不使用
+        TcpServer(uint16_t _port, const std::string& _ip = "0.0.0.0", Epoller::Backend _backend = Epoller::EPOLL)
+            : port(_port), ip(_ip), id(0), inactive_release(false), edge_trigger(false), ring_buffer(false), zerocopy_threshold(0), reuse_port(false), accept_batch(64), base_loop(_backend), acceptor(&base_loop, _port, _ip), loop_pool(&base_loop) {
             acceptor.set_accept_cb(std::bind(&TcpServer::new_connection, this, std::placeholders::_1));
             acceptor.listen();
         }
 
         void set_thread_count(int count) {
-            logging.info("设置LoopThreadPool线程池的线程数为: %d", count);
+            LOG_INFO("设置LoopThreadPool线程池的线程数为: %d", count);
             loop_pool.set_thread_count(count);
         }
 
@@ -90,11 +130,73 @@ namespace muduo
         }
 
         void enable_inactive_release(int _timeout) {
-            logging.info("设置TcpServer的超时关闭时间为: %d s", _timeout);
+            LOG_INFO("设置TcpServer的超时关闭时间为: %d s", _timeout);
             timeout = _timeout;
             inactive_release = true;
         }
 
+        //新连接使用边缘触发, 可写事件常驻, 不再随发送缓冲区反复修改epoll
+        void enable_edge_trigger() {
+            LOG_INFO("设置TcpServer的连接为边缘触发模式");
+            edge_trigger = true;
+        }
+
+        //新连接的输入缓冲区使用环形布局, 不完整的消息留在缓冲区中时不再前移数据
+        //消息回调需要通过 Buffer::peek_spans 访问可读数据
+        void enable_ring_buffer() {
+            ring_buffer = true;
+        }
+
+        //新连接中不小于 _threshold 字节的数据块以 MSG_ZEROCOPY 发送, 不支持时自动退回普通发送
+        void enable_zerocopy(size_t _threshold) {
+            zerocopy_threshold = _threshold;
+        }
+
+        //多监听模式: 每个loop线程持有自己的 SO_REUSEPORT 监听套接字并自行accept, 由内核分散新连接
+        //需在 start 之前调用, 没有设置线程数时不生效
+        void enable_reuse_port() {
+            LOG_INFO("设置TcpServer为多监听模式");
+            reuse_port = true;
+        }
+
+        //新连接分配到loop的策略, 多监听模式下由内核分配, 不使用该策略
+        void set_loop_policy(LoopThreadPool::Policy _policy) {
+            loop_pool.set_policy(_policy);
+        }
+
+        void set_loop_select_cb(const LoopThreadPool::select_func& _cb) {
+            loop_pool.set_select_cb(_cb);
+        }
+
+        //loop线程依次绑定到 _cpus 中的CPU, 需在 start 之前调用
+        void set_cpu_affinity(const std::vector<int>& _cpus) {
+            loop_pool.set_cpu_affinity(_cpus);
+        }
+
+        //各个loop的连接数与事件数, 用于观察负载是否均衡
+        std::vector<LoopLoad> get_loop_loads() {
+            return loop_pool.get_loads();
+        }
+
+        //设置一次可读事件中最多accept的连接数, 需在 start 之前调用
+        void set_accept_batch(int _batch) {
+            accept_batch = _batch;
+            acceptor.set_accept_batch(_batch);
+            for (auto& extra : extra_acceptors) {
+                extra->set_accept_batch(_batch);
+            }
+        }
+
+        //额外监听一个地址, 例如同时监听TCP端口和 "unix:<路径>", 新连接共用同一组loop线程
+        //需在 start 之前调用
+        void add_listen(uint16_t _port, const std::string& _ip) {
+            Acceptor* extra = new Acceptor(&base_loop, _port, _ip);
+            extra->set_accept_batch(accept_batch);
+            extra->set_accept_cb(std::bind(&TcpServer::new_connection, this, std::placeholders::_1));
+            extra->listen();
+            extra_acceptors.emplace_back(extra);
+        }
+
         //添加一个定时任务
         void run_after(const task_func& _task, int _delay) {
             base_loop.run_in_loop(std::bind(&TcpServer::run_after_in_loop, this, _task, _delay));
@@ -102,6 +204,14 @@ namespace muduo
 
         void start() {
             loop_pool.create();
+            //同一路径只能绑定一个 unix 套接字, 多监听模式只对 TCP 生效
+            if (reuse_port == true && Socket::is_unix_address(ip)) {
+                LOG_WARNING("unix 套接字 %s 不支持多监听模式, 由base_loop统一accept", ip.c_str());
+                reuse_port = false;
+            }
+            if (reuse_port == true && loop_pool.get_all_loops().front() != &base_loop) {
+                start_loop_acceptors();
+            }
             base_loop.start();
         }
 
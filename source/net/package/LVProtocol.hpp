@@ -1,12 +1,17 @@
 #pragma once
 
 #include <arpa/inet.h>
+#include <endian.h>
+#include <cstring>
 #include "../abstract/BaseProtocol.hpp"
 #include "../abstract/BaseBuffer.hpp"
 #include "../factory/MessageFactory.hpp"
+#include "../../util/uuid.hpp"
 
 // |Length|VALUE|
-// |Length|MsgType|IDLength|ID|Data|
+// V1: |Length|MsgType|IDLength|ID|Data|
+// V2: |Length|Version|MsgType|ID|Data|, Version 与 MsgType 共用4字节, ID 为大端的8字节整数
+// 两种格式都能解析, V1 的 MsgType 高8位为0, 据此区分
 namespace rpc
 {
     class LVProtocol : public BaseProtocol {
@@ -14,9 +19,21 @@ namespace rpc
         static const int32_t length_field_size = sizeof(int32_t);
         static const int32_t msgtype_field_size = sizeof(int32_t);
         static const int32_t idlength_field_size = sizeof(int32_t);
+        static const int32_t id_field_size = sizeof(uint64_t);
+        static const int version_shift = 24;
+
+        // 发给 V1 对端的消息如果不是对它的回复, 用16位十六进制表示整数 ID
+        static std::string legacy_id_of(const BaseMessage::ptr& message) {
+            if (message->is_legacy()) {
+                return message->get_legacy_id();
+            }
+            std::string id(16, '\0');
+            UUID::to_hex(message->get_id(), &id[0]);
+            return id;
+        }
     public:
         using ptr = std::shared_ptr<LVProtocol>;
-        
+
         // 判断缓冲区中数据是否足够处理一条消息
         virtual bool can_process(const BaseBuffer::ptr& buffer) {
             if (buffer->read_able_size() < length_field_size) {
@@ -32,40 +49,102 @@ namespace rpc
         virtual bool on_message(const BaseBuffer::ptr& buffer, BaseMessage::ptr& message) {
             // 调用on_messsage时数据已经足够
             int32_t total_len = buffer->read_int32();
-            MsgType msgtype = static_cast<MsgType>(buffer->read_int32());
-            int32_t id_length = buffer->read_int32();
-            int32_t body_length = total_len - msgtype_field_size - idlength_field_size - id_length;
-            std::string id = buffer->retrieve_as_string(id_length);
-            std::string body = buffer->retrieve_as_string(body_length);
+            int32_t type_field = buffer->read_int32();
+            int version = static_cast<uint32_t>(type_field) >> version_shift;
+            MsgType msgtype = static_cast<MsgType>(type_field & ((1 << version_shift) - 1));
+            int32_t id_length;
+            if (version == static_cast<int>(WireVersion::V2)) {
+                id_length = id_field_size;
+            }
+            else if (version == 0) {
+                id_length = buffer->read_int32();
+                total_len -= idlength_field_size;
+            }
+            else {
+                LOG_ERROR("不支持的协议版本: %d", version);
+                return false;
+            }
+            int32_t body_length = total_len - msgtype_field_size - id_length;
+            if (id_length < 0 || body_length < 0) {
+                LOG_ERROR("消息长度字段错误");
+                return false;
+            }
             message = MessageFactory::create(msgtype);
             if(!message.get()) {
-                logging.error("消息类型错误");
+                LOG_ERROR("消息类型错误");
                 return false;
             }
-            if(!message->deserialize(body)) {
-                logging.error("反序列化失败");
+            // ID 和消息体留在缓冲区中原地解析, 解析完成后再一起从缓冲区中移除
+            BaseBuffer::Span view[2];
+            int count = buffer->read_view(0, id_length, view);
+            if (version == 0) {
+                std::string id;
+                id.reserve(id_length);
+                for (int i = 0; i < count; i++) {
+                    id.append(view[i].data, view[i].len);
+                }
+                message->set_legacy_id(id);
+            }
+            else {
+                uint64_t id = 0;
+                char* pos = reinterpret_cast<char*>(&id);
+                for (int i = 0; i < count; i++) {
+                    memcpy(pos, view[i].data, view[i].len);
+                    pos += view[i].len;
+                }
+                message->set_id(be64toh(id));
+            }
+            count = buffer->read_view(id_length, body_length, view);
+            bool ok = message->deserialize(view, count);
+            buffer->move_read(id_length + body_length);
+            if(!ok) {
+                LOG_ERROR("反序列化失败");
                 return false;
             }
             message->set_type(msgtype);
-            message->set_id(id);
             return true;
         }
 
-        virtual std::string serialize(const BaseMessage::ptr& message) {
-            std::string body = message->serialize();
-            std::string id = message->get_id();
-            int32_t id_length = htonl(id.size());
-            int32_t mtype = htonl(static_cast<int32_t>(message->get_type()));
-            int32_t h_total_length = msgtype_field_size + idlength_field_size + id.size() + body.size();
-            int32_t n_total_length = htonl(h_total_length);
-            std::string result;
-            result.reserve(h_total_length);
-            result.append((char*)&n_total_length, length_field_size);
-            result.append((char*)&mtype, msgtype_field_size);
-            result.append((char*)&id_length, idlength_field_size);
-            result.append(id);
-            result.append(body);
+        // 先算出消息体的大小, 一次分配整个帧, 消息体直接编码到帧中, 最后回填长度字段
+        // 返回的字符串由连接直接作为发送块, 不再拷贝
+        virtual std::string serialize(const BaseMessage::ptr& message, WireVersion version) {
+            size_t body_size = message->byte_size();
+            int32_t mtype = static_cast<int32_t>(message->get_type());
+            std::string id;
+            size_t header_size = length_field_size + msgtype_field_size;
+            if (version == WireVersion::V1) {
+                id = legacy_id_of(message);
+                header_size += idlength_field_size + id.size();
+            }
+            else {
+                mtype |= static_cast<int32_t>(WireVersion::V2) << version_shift;
+                header_size += id_field_size;
+            }
+            std::string result(header_size + body_size, '\0');
+            char* pos = &result[0] + length_field_size;
+            mtype = htonl(mtype);
+            memcpy(pos, &mtype, msgtype_field_size);
+            pos += msgtype_field_size;
+            if (version == WireVersion::V1) {
+                int32_t id_length = htonl(id.size());
+                memcpy(pos, &id_length, idlength_field_size);
+                pos += idlength_field_size;
+                memcpy(pos, id.data(), id.size());
+                pos += id.size();
+            }
+            else {
+                uint64_t n_id = htobe64(message->get_id());
+                memcpy(pos, &n_id, id_field_size);
+                pos += id_field_size;
+            }
+            char* end = message->serialize_to(pos);
+            if (end == nullptr || static_cast<size_t>(end - pos) != body_size) {
+                LOG_ERROR("消息序列化失败");
+                return "";
+            }
+            int32_t n_total_length = htonl(static_cast<int32_t>(end - &result[0] - length_field_size));
+            memcpy(&result[0], &n_total_length, length_field_size);
             return result;
         }
     };
-}
\ No newline at end of file
+}
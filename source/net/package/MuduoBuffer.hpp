@@ -22,20 +22,19 @@ namespace rpc
 
         virtual int32_t peek_int32() override {
             if (buffer->read_able_size() < sizeof(int32_t)) {
-                logging.error("缓冲区数据不足，无法读取int32_t类型数据");
+                LOG_ERROR("缓冲区数据不足，无法读取int32_t类型数据");
             }
-            int32_t value;
-            ::memcpy(&value, buffer->get_read_idx(), sizeof(int32_t));
+            int32_t value = 0;
+            buffer->peek(reinterpret_cast<char*>(&value), sizeof(int32_t));
             return ntohl(value); // 网络字节序转主机字节序
         }
 
         // 字节序未转换
         virtual void retrieve_int32(int32_t& _data) override {
             if (buffer->read_able_size() < sizeof(int32_t)) {
-                logging.error("缓冲区数据不足，无法读取int32_t类型数据");
+                LOG_ERROR("缓冲区数据不足，无法读取int32_t类型数据");
             }
-            ::memcpy(&_data, buffer->get_read_idx(), sizeof(int32_t));
-            buffer->move_read(sizeof(int32_t));
+            buffer->read(reinterpret_cast<char*>(&_data), sizeof(int32_t));
         }
 
         virtual int32_t read_int32() override {
@@ -46,11 +45,27 @@ namespace rpc
 
         virtual std::string retrieve_as_string(size_t len) override {
             if (buffer->read_able_size() < len) {
-                logging.error("缓冲区数据不足，无法读取指定长度的字符串");
+                LOG_ERROR("缓冲区数据不足，无法读取指定长度的字符串");
+            }
+            return buffer->read_string(len);
+        }
+
+        virtual void move_read(size_t len) override {
+            if (buffer->read_able_size() < len) {
+                LOG_ERROR("缓冲区数据不足，无法丢弃指定长度的数据");
+                len = buffer->read_able_size();
             }
-            std::string str(buffer->get_read_idx(), len);
             buffer->move_read(len);
-            return str;
+        }
+
+        virtual int peek_spans(Span* spans) override {
+            struct iovec vec[2];
+            int count = buffer->peek_spans(vec);
+            for (int i = 0; i < count; i++) {
+                spans[i].data = static_cast<const char*>(vec[i].iov_base);
+                spans[i].len = vec[i].iov_len;
+            }
+            return count;
         }
     };
 }
\ No newline at end of file
@@ -23,11 +23,11 @@ namespace rpc {
 
         void on_connected(const muduo::Connection::ptr& _conn) {
             if(_conn->is_connected()) {
-                latch.count_down();
                 conn = ConnectionFactory::create(_conn, protocol);
+                latch.count_down();
             }
             else {
-                logging.info("连接断开!");
+                LOG_INFO("连接断开!");
                 conn.reset();
             }
         }
@@ -36,9 +36,9 @@ namespace rpc {
             auto base_buffer = BufferFactory::create(_buf);
             while(true) {
                 if(!protocol->can_process(base_buffer)) {
-                    // logging.info("数据包不完整，等待数据包继续接收!"); 
+                    // LOG_INFO("数据包不完整，等待数据包继续接收!"); 
                     if(base_buffer->read_able_size() > max_data_length) {
-                        logging.info("数据包过大，关闭连接!"); 
+                        LOG_INFO("数据包过大，关闭连接!"); 
                         _conn->shutdown();
                         return;
                     }
@@ -46,10 +46,13 @@ namespace rpc {
                 }
                 BaseMessage::ptr base_message;
                 if(!protocol->on_message(base_buffer, base_message)) {
-                    logging.info("数据包解析失败，关闭连接!"); 
+                    LOG_INFO("数据包解析失败，关闭连接!"); 
                     _conn->shutdown();
                     return;
                 }
+                if(conn) {
+                    conn->on_peer_message(base_message);
+                }
                 if(msg_cb) {
                     msg_cb(conn, base_message);
                 }
@@ -64,7 +67,9 @@ namespace rpc {
         : protocol(ProtocolFactory::create())
         , latch(1)
         , base_loop(loop_thread.get_loop())
-        , client(base_loop, ip, port) {}
+        , client(base_loop, ip, port) {
+            client.enable_ring_buffer();
+        }
 
         virtual void connect() override {
             client.set_conn_cb(std::bind(&MuduoClient::on_connected, this, std::placeholders::_1));
@@ -79,7 +84,7 @@ namespace rpc {
 
         virtual bool send(const BaseMessage::ptr& msg) {
             if(is_connected() == false) {
-                logging.error("连接断开，发送失败!");
+                LOG_ERROR("连接断开，发送失败!");
                 return false;
             }
             conn->send(msg);
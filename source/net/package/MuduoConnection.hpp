@@ -5,7 +5,7 @@
 #include "../abstract/BaseConnection.hpp"
 
 namespace rpc {
-    class MuduoConnection : public BaseConnection {
+    class MuduoConnection : public BaseConnection, public std::enable_shared_from_this<MuduoConnection> {
     private:
         BaseProtocol::ptr protocol;
         muduo::Connection::ptr conn;
@@ -15,8 +15,7 @@ namespace rpc {
         MuduoConnection(const muduo::Connection::ptr conn, const BaseProtocol::ptr protocol) : conn(conn), protocol(protocol) {}
 
         virtual void send(const BaseMessage::ptr& message) {
-            std::string body = protocol->serialize(message);
-            conn->send(body.c_str(), body.size());
+            conn->send(protocol->serialize(message, get_wire_version()));
         }
         virtual void shutdown() {
             conn->shutdown();
@@ -24,5 +23,35 @@ namespace rpc {
         virtual bool is_connected() {
             return conn->is_connected();
         }
+
+        // 回调中只持有弱引用, 连接对象与 muduo::Connection 之间不形成循环引用
+        virtual void set_water_mark(size_t high, size_t low, const WaterMarkCallBack& high_cb, const WaterMarkCallBack& low_cb) {
+            std::weak_ptr<MuduoConnection> weak_self = shared_from_this();
+            conn->set_water_mark(high, low);
+            conn->set_high_water_cb([weak_self, high_cb](const muduo::Connection::ptr&, size_t pending) {
+                auto self = weak_self.lock();
+                if (self && high_cb) {
+                    high_cb(self, pending);
+                }
+            });
+            conn->set_low_water_cb([weak_self, low_cb](const muduo::Connection::ptr&, size_t pending) {
+                auto self = weak_self.lock();
+                if (self && low_cb) {
+                    low_cb(self, pending);
+                }
+            });
+        }
+
+        virtual bool is_congested() {
+            return conn->is_above_high_water();
+        }
+
+        virtual void pause_read() {
+            conn->stop_read();
+        }
+
+        virtual void resume_read() {
+            conn->start_read();
+        }
     };
 }
\ No newline at end of file
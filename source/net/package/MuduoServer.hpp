@@ -18,7 +18,7 @@ namespace rpc {
 
         void on_connected(const muduo::Connection::ptr& conn) {
             if(conn->is_connected()) {
-                logging.info("客户端连接成功!");
+                LOG_INFO("客户端连接成功!");
                 auto muduo_conn = ConnectionFactory::create(conn, protocol);
                 {
                     std::unique_lock<std::mutex> lock(mtx);
@@ -29,7 +29,7 @@ namespace rpc {
                 }
             }
             else {
-                logging.info("客户端断开连接!");
+                LOG_INFO("客户端断开连接!");
                 auto muduo_conn = ConnectionFactory::create(conn, protocol);
                 {
                     std::unique_lock<std::mutex> lock(mtx);
@@ -48,9 +48,9 @@ namespace rpc {
             auto base_buffer = BufferFactory::create(buf);
             while(true) {
                 if(!protocol->can_process(base_buffer)) {
-                    // logging.info("数据包不完整，等待数据包继续接收!"); 
+                    // LOG_INFO("数据包不完整，等待数据包继续接收!"); 
                     if(base_buffer->read_able_size() > max_data_length) {
-                        logging.info("数据包过大，关闭连接!"); 
+                        LOG_INFO("数据包过大，关闭连接!"); 
                         conn->shutdown();
                         return;
                     }
@@ -58,7 +58,7 @@ namespace rpc {
                 }
                 BaseMessage::ptr base_message;
                 if(!protocol->on_message(base_buffer, base_message)) {
-                    logging.info("数据包解析失败，关闭连接!"); 
+                    LOG_INFO("数据包解析失败，关闭连接!"); 
                     conn->shutdown();
                     return;
                 }
@@ -71,6 +71,7 @@ namespace rpc {
                     }
                     base_conn = it->second;
                 }
+                base_conn->on_peer_message(base_message);
                 if(msg_cb) {
                     msg_cb(base_conn, base_message);
                 }
@@ -81,7 +82,18 @@ namespace rpc {
 
         MuduoServer(int port, const std::string& ip)
         : server(port, ip)
-        , protocol(ProtocolFactory::create()) {}
+        , protocol(ProtocolFactory::create()) {
+            //MuduoBuffer 只通过区间访问数据, 输入缓冲区可以使用环形布局, 半个消息留在缓冲区时不再前移
+            server.enable_ring_buffer();
+        }
+
+        virtual void enable_zerocopy(size_t threshold) override {
+            server.enable_zerocopy(threshold);
+        }
+
+        virtual void add_listen(int port, const std::string& ip) override {
+            server.add_listen(port, ip);
+        }
 
         void start() {
             server.set_conn_cb(std::bind(&MuduoServer::on_connected, this, std::placeholders::_1));
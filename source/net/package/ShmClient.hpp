@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../abstract/BaseClient.hpp"
+#include "../factory/ProtocolFactory.hpp"
+#include "../muduo/package/LoopThread.hpp"
+#include "../muduo/package/Socket.hpp"
+#include "ShmServer.hpp"
+
+namespace rpc {
+    // 共享内存传输的客户端, 地址写作 "shm:<路径>", 与服务端的握手过程见 ShmServer
+    class ShmClient : public BaseClient {
+    private:
+        BaseProtocol::ptr protocol;
+        std::string handshake_ip;
+        muduo::LoopThread loop_thread;
+        muduo::EventLoop* base_loop;
+        ShmConnection::ptr conn;
+
+        static constexpr int max_retry_delay = 8;
+
+        // 连接握手套接字并取得共享内存, 失败时关闭已经打开的描述符
+        bool handshake(ShmResource& res) {
+            sockaddr_un addr;
+            socklen_t len;
+            if (!muduo::Socket::fill_unix_addr(handshake_ip, addr, len)) {
+                return false;
+            }
+            res.sock_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (::connect(res.sock_fd, reinterpret_cast<sockaddr*>(&addr), len) < 0) {
+                LOG_WARNING("连接共享内存服务端 %s 失败: %s", handshake_ip.c_str(), strerror(errno));
+                res.close_all();
+                return false;
+            }
+            if (!res.recv_handshake()) {
+                res.close_all();
+                return false;
+            }
+            int flag = fcntl(res.sock_fd, F_GETFL, 0);
+            fcntl(res.sock_fd, F_SETFL, flag | O_NONBLOCK);
+            return true;
+        }
+
+    public:
+        using ptr = std::shared_ptr<ShmClient>;
+
+        ShmClient(const std::string& ip)
+            : protocol(ProtocolFactory::create())
+            , handshake_ip(ShmServer::handshake_address(ip))
+            , base_loop(loop_thread.get_loop()) {}
+
+        ~ShmClient() {
+            shutdown();
+        }
+
+        // 与 MuduoClient 一致, 阻塞到连接建立为止, 服务端还没有启动时逐渐拉长重试间隔
+        virtual void connect() override {
+            ShmResource res;
+            for (int delay = 1; !handshake(res); delay = std::min(delay * 2, max_retry_delay)) {
+                LOG_INFO("将在 %ds 后重试连接 %s", delay, handshake_ip.c_str());
+                sleep(delay);
+            }
+            auto new_conn = std::make_shared<ShmConnection>(base_loop, protocol, res, false);
+            if (!new_conn->init(false)) {
+                return;
+            }
+            new_conn->set_msg_cb(msg_cb);
+            //连接可能在客户端析构之后才在loop中关闭, 回调不能引用 this
+            new_conn->set_close_cb([cb = close_cb](const ShmConnection::ptr& _conn) {
+                LOG_INFO("连接断开!");
+                if (cb) {
+                    cb(_conn);
+                }
+            });
+            conn = new_conn;
+            conn->established();
+        }
+
+        virtual void shutdown() override {
+            if (conn) {
+                conn->shutdown();
+            }
+        }
+
+        virtual bool send(const BaseMessage::ptr& msg) override {
+            if(is_connected() == false) {
+                LOG_ERROR("连接断开，发送失败!");
+                return false;
+            }
+            conn->send(msg);
+            return true;
+        }
+
+        virtual BaseConnection::ptr get_connection() override {
+            return conn;
+        }
+
+        virtual bool is_connected() override {
+            return conn && conn->is_connected();
+        }
+    };
+}
@@ -0,0 +1,407 @@
+#pragma once
+
+#include "ShmRing.hpp"
+#include "../abstract/BaseConnection.hpp"
+#include "../abstract/BaseProtocol.hpp"
+#include "../muduo/package/EventLoop.hpp"
+#include "../muduo/package/Channel.hpp"
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <deque>
+#include <mutex>
+
+namespace rpc {
+    // 共享内存连接的资源: 一块 memfd 映射出的内存中放着两个方向的 ShmRing, 每端各一个 eventfd
+    // 环0为客户端到服务端, 环1为服务端到客户端
+    // 握手用的 unix 套接字保留下来, 不再传输数据, 只用来感知对端进程退出
+    struct ShmResource {
+        int mem_fd = -1;
+        int server_efd = -1;
+        int client_efd = -1;
+        int sock_fd = -1;
+        uint32_t capacity = 0; // 每个环的数据区大小, 2的幂
+
+        size_t region_size() const {
+            return ShmRing::region_size(capacity) * 2;
+        }
+
+        void close_all() {
+            for (int* fd : { &mem_fd, &server_efd, &client_efd, &sock_fd }) {
+                if (*fd >= 0) {
+                    ::close(*fd);
+                    *fd = -1;
+                }
+            }
+        }
+
+        // 服务端创建共享内存和两个 eventfd
+        bool create(uint32_t _capacity) {
+            capacity = _capacity;
+            mem_fd = ::memfd_create("rpc-shm", MFD_CLOEXEC);
+            if (mem_fd < 0 || ::ftruncate(mem_fd, region_size()) < 0) {
+                LOG_ERROR("创建共享内存失败: %s", strerror(errno));
+                return false;
+            }
+            server_efd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            client_efd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (server_efd < 0 || client_efd < 0) {
+                LOG_ERROR("创建eventfd失败: %s", strerror(errno));
+                return false;
+            }
+            return true;
+        }
+
+        // 通过 unix 套接字把环的容量和三个描述符(SCM_RIGHTS)交给客户端
+        bool send_handshake() {
+            int fds[3] = { mem_fd, server_efd, client_efd };
+            char control[CMSG_SPACE(sizeof(fds))] = {0};
+            struct iovec vec = { &capacity, sizeof(capacity) };
+            struct msghdr msg = {};
+            msg.msg_iov = &vec;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            struct cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+            cm->cmsg_level = SOL_SOCKET;
+            cm->cmsg_type = SCM_RIGHTS;
+            cm->cmsg_len = CMSG_LEN(sizeof(fds));
+            memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+            if (::sendmsg(sock_fd, &msg, MSG_NOSIGNAL) != sizeof(capacity)) {
+                LOG_ERROR("发送共享内存握手失败: %s", strerror(errno));
+                return false;
+            }
+            return true;
+        }
+
+        // 客户端在阻塞的 unix 套接字上接收握手
+        bool recv_handshake() {
+            int fds[3];
+            char control[CMSG_SPACE(sizeof(fds))] = {0};
+            struct iovec vec = { &capacity, sizeof(capacity) };
+            struct msghdr msg = {};
+            msg.msg_iov = &vec;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            if (::recvmsg(sock_fd, &msg, MSG_CMSG_CLOEXEC) != sizeof(capacity)) {
+                LOG_ERROR("接收共享内存握手失败: %s", strerror(errno));
+                return false;
+            }
+            struct cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+            if (cm == nullptr || cm->cmsg_type != SCM_RIGHTS || cm->cmsg_len != CMSG_LEN(sizeof(fds))) {
+                LOG_ERROR("共享内存握手中没有描述符");
+                return false;
+            }
+            memcpy(fds, CMSG_DATA(cm), sizeof(fds));
+            mem_fd = fds[0];
+            server_efd = fds[1];
+            client_efd = fds[2];
+            if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+                LOG_ERROR("共享内存环的容量错误: %u", capacity);
+                return false;
+            }
+            return true;
+        }
+    };
+
+    // 共享内存上的一条连接
+    // 发送: 序列化后直接写入发送环, 对端正在处理数据时不做任何系统调用, 只有对端空闲时才写它的 eventfd
+    // 接收: 在所属loop中监控自己的 eventfd, 协议层直接从接收环中解析消息
+    // 发送环满时数据暂存在 pending 中, 对端腾出空间后写自己的 eventfd, 由loop线程继续写出
+    class ShmConnection : public BaseConnection, public std::enable_shared_from_this<ShmConnection> {
+    public:
+        using ptr = std::shared_ptr<ShmConnection>;
+        using MessageCallBack = std::function<void(const BaseConnection::ptr&, const BaseMessage::ptr&)>;
+        using CloseCallBack = std::function<void(const ShmConnection::ptr&)>;
+
+    private:
+        muduo::EventLoop* loop;
+        BaseProtocol::ptr protocol;
+        ShmResource res;
+        void* region;
+        int self_efd;
+        int peer_efd;
+        ShmRing tx_ring;
+        ShmRing rx_ring;
+        ShmBuffer rx_buffer;
+        std::unique_ptr<muduo::Channel> efd_channel;
+        std::unique_ptr<muduo::Channel> sock_channel;
+
+        std::mutex send_mtx; // 发送可能来自任意线程, 环只允许一个生产者
+        std::deque<std::string> pending; // 发送环写不下的数据
+        size_t pending_offset; // pending 队首已经写入环中的字节数
+        size_t pending_bytes;
+        std::atomic<bool> connected;
+        std::atomic<bool> reading;
+
+        size_t high_water_mark;
+        size_t low_water_mark;
+        std::atomic<bool> above_high_water;
+        WaterMarkCallBack high_water_cb;
+        WaterMarkCallBack low_water_cb;
+
+        MessageCallBack msg_cb;
+        CloseCallBack close_cb;
+
+        static void notify(int _efd) {
+            uint64_t one = 1;
+            ssize_t ret = ::write(_efd, &one, sizeof(one));
+            (void)ret;
+        }
+
+        // 需持有 send_mtx: 按顺序写出 pending 中的数据, 环满时登记等待空间
+        // 返回是否向环中写入了数据
+        bool flush_pending_locked() {
+            bool wrote = false;
+            while (!pending.empty()) {
+                std::string& front = pending.front();
+                size_t n = tx_ring.write(front.data() + pending_offset, front.size() - pending_offset);
+                if (n == 0) {
+                    if (!tx_ring.wait_for_space()) {
+                        break;
+                    }
+                    continue;
+                }
+                wrote = true;
+                pending_offset += n;
+                pending_bytes -= n;
+                if (pending_offset == front.size()) {
+                    pending.pop_front();
+                    pending_offset = 0;
+                }
+            }
+            return wrote;
+        }
+
+        // 对端腾出了发送空间, 或者向接收环写入了数据
+        void handle_event() {
+            uint64_t count;
+            ssize_t ret = ::read(self_efd, &count, sizeof(count));
+            (void)ret;
+            size_t remain = 0;
+            {
+                std::lock_guard<std::mutex> lock(send_mtx);
+                if (connected && !pending.empty()) {
+                    if (flush_pending_locked() && tx_ring.reader_needs_wakeup()) {
+                        notify(peer_efd);
+                    }
+                }
+                remain = pending_bytes;
+            }
+            if (above_high_water && remain <= low_water_mark && above_high_water.exchange(false)) {
+                if (low_water_cb) {
+                    low_water_cb(shared_from_this(), remain);
+                }
+            }
+            handle_read();
+        }
+
+        // 解析接收环中所有完整的消息, 没有数据后登记空闲再回到事件循环
+        void handle_read() {
+            //与连接共享引用计数, 不额外分配
+            BaseBuffer::ptr buffer(shared_from_this(), &rx_buffer);
+            while (connected && reading) {
+                rx_ring.leave_idle();
+                while (connected && reading && protocol->can_process(buffer)) {
+                    BaseMessage::ptr message;
+                    if (!protocol->on_message(buffer, message)) {
+                        LOG_INFO("数据包解析失败，关闭连接!");
+                        shutdown();
+                        return;
+                    }
+                    on_peer_message(message);
+                    if (msg_cb) {
+                        msg_cb(shared_from_this(), message);
+                    }
+                }
+                if (rx_ring.writer_needs_wakeup()) {
+                    notify(peer_efd);
+                }
+                if (!connected || !reading) {
+                    //暂停读取时不登记空闲, 恢复读取时由 resume_read 唤醒自己
+                    return;
+                }
+                //先记下剩余的字节数再判断, 之后写入的数据会让 prepare_idle 失败, 不会漏掉
+                size_t seen = rx_ring.read_able_size();
+                if (protocol->can_process(buffer)) {
+                    continue;
+                }
+                //环已满仍不足一条消息, 对端永远无法写完这条消息
+                if (seen == res.capacity) {
+                    LOG_ERROR("消息超过共享内存环的容量 %u, 关闭连接!", res.capacity);
+                    shutdown();
+                    return;
+                }
+                if (rx_ring.prepare_idle(seen)) {
+                    return;
+                }
+            }
+        }
+
+        // 握手套接字可读只可能是对端关闭了连接
+        void handle_peer_close() {
+            char buf[16];
+            ssize_t ret = ::recv(res.sock_fd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (ret < 0 && (errno == EAGAIN || errno == EINTR)) {
+                return;
+            }
+            close_in_loop();
+        }
+
+        void close_in_loop() {
+            {
+                // 持有发送锁修改状态, 保证没有其他线程还在写发送环
+                std::lock_guard<std::mutex> lock(send_mtx);
+                if (!connected) {
+                    return;
+                }
+                connected = false;
+            }
+            for (muduo::Channel* channel : { efd_channel.get(), sock_channel.get() }) {
+                if (channel != nullptr) {
+                    channel->disable_all();
+                    channel->remove();
+                }
+            }
+            ptr self = shared_from_this();
+            if (close_cb) {
+                close_cb(self);
+            }
+            //在事件处理结束之后再释放描述符和映射, 当前可能正处在 Channel 的回调中
+            loop->push_task([self]() {
+                self->release();
+            });
+        }
+
+        void release() {
+            efd_channel.reset();
+            sock_channel.reset();
+            if (region != nullptr) {
+                ::munmap(region, res.region_size());
+                region = nullptr;
+            }
+            res.close_all();
+        }
+
+    public:
+        // _res 中的描述符归连接所有, _is_server 决定使用哪个环发送
+        ShmConnection(muduo::EventLoop* _loop, const BaseProtocol::ptr& _protocol, const ShmResource& _res, bool _is_server)
+            : loop(_loop), protocol(_protocol), res(_res), region(nullptr)
+            , self_efd(_is_server ? _res.server_efd : _res.client_efd)
+            , peer_efd(_is_server ? _res.client_efd : _res.server_efd)
+            , rx_buffer(&rx_ring), pending_offset(0), pending_bytes(0), connected(false), reading(true)
+            , high_water_mark(0), low_water_mark(0), above_high_water(false) {}
+
+        ~ShmConnection() {
+            release();
+        }
+
+        // 映射共享内存, 服务端同时初始化两个环
+        bool init(bool _is_server) {
+            region = ::mmap(nullptr, res.region_size(), PROT_READ | PROT_WRITE, MAP_SHARED, res.mem_fd, 0);
+            if (region == MAP_FAILED) {
+                region = nullptr;
+                LOG_ERROR("映射共享内存失败: %s", strerror(errno));
+                return false;
+            }
+            char* c2s = static_cast<char*>(region);
+            char* s2c = c2s + ShmRing::region_size(res.capacity);
+            tx_ring.attach(_is_server ? s2c : c2s, res.capacity, _is_server);
+            rx_ring.attach(_is_server ? c2s : s2c, res.capacity, _is_server);
+            return true;
+        }
+
+        void set_msg_cb(const MessageCallBack& _cb) {
+            msg_cb = _cb;
+        }
+
+        void set_close_cb(const CloseCallBack& _cb) {
+            close_cb = _cb;
+        }
+
+        // 开始在loop中监控事件, 需在 init 成功之后调用
+        void established() {
+            connected = true;
+            loop->run_in_loop([self = shared_from_this()]() {
+                self->efd_channel.reset(new muduo::Channel(self->self_efd, self->loop));
+                self->efd_channel->set_read_cb(std::bind(&ShmConnection::handle_event, self.get()));
+                self->efd_channel->tie(self);
+                self->efd_channel->enable_read();
+                self->sock_channel.reset(new muduo::Channel(self->res.sock_fd, self->loop));
+                self->sock_channel->set_read_cb(std::bind(&ShmConnection::handle_peer_close, self.get()));
+                self->sock_channel->tie(self);
+                self->sock_channel->enable_read();
+                //建立之前对端可能已经写入了数据
+                self->handle_read();
+            });
+        }
+
+        virtual void send(const BaseMessage::ptr& message) override {
+            std::string data = protocol->serialize(message, get_wire_version());
+            size_t remain = 0;
+            {
+                std::lock_guard<std::mutex> lock(send_mtx);
+                if (!connected) {
+                    LOG_WARNING("共享内存连接已关闭, 丢弃消息");
+                    return;
+                }
+                //已有积压时追加到队尾, 保证消息顺序
+                size_t written = pending.empty() ? tx_ring.write(data.data(), data.size()) : 0;
+                bool wrote = written > 0;
+                if (written < data.size()) {
+                    pending_bytes += data.size() - written;
+                    if (written == 0) {
+                        pending.emplace_back(std::move(data));
+                    }
+                    else {
+                        pending.emplace_back(data, written);
+                    }
+                    wrote = flush_pending_locked() || wrote;
+                }
+                if (wrote && tx_ring.reader_needs_wakeup()) {
+                    notify(peer_efd);
+                }
+                remain = pending_bytes;
+            }
+            if (high_water_mark > 0 && remain >= high_water_mark && !above_high_water.exchange(true)) {
+                if (high_water_cb) {
+                    high_water_cb(shared_from_this(), remain);
+                }
+            }
+        }
+
+        virtual void shutdown() override {
+            //总是投递到loop中执行, 消息回调中关闭连接时不会在解析途中释放映射
+            loop->push_task([self = shared_from_this()]() {
+                self->close_in_loop();
+            });
+        }
+
+        virtual bool is_connected() override {
+            return connected;
+        }
+
+        virtual void set_water_mark(size_t high, size_t low, const WaterMarkCallBack& high_cb, const WaterMarkCallBack& low_cb) override {
+            high_water_mark = high;
+            low_water_mark = low;
+            high_water_cb = high_cb;
+            low_water_cb = low_cb;
+        }
+
+        virtual bool is_congested() override {
+            return above_high_water;
+        }
+
+        virtual void pause_read() override {
+            reading = false;
+        }
+
+        // 暂停期间没有登记空闲, 对端不会唤醒, 这里唤醒自己继续处理积压的消息
+        virtual void resume_read() override {
+            if (!reading.exchange(true)) {
+                notify(self_efd);
+            }
+        }
+    };
+}
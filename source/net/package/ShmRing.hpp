@@ -0,0 +1,214 @@
+#pragma once
+
+#include "../abstract/BaseBuffer.hpp"
+#include "../../util/Log.hpp"
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <cstring>
+#include <arpa/inet.h>
+
+namespace rpc
+{
+    // 放在共享内存中的单生产者单消费者字节环, 两个进程各持有一端
+    // 生产者只写 tail, 消费者只写 head, 两个下标单调递增, 对容量取模得到位置
+    // reader_idle/writer_waiting 用来决定是否需要通过 eventfd 唤醒对端:
+    // 对端正在处理时只移动下标, 不产生任何系统调用
+    class ShmRing {
+    public:
+        struct Header {
+            alignas(64) std::atomic<uint64_t> tail; // 生产者写
+            std::atomic<uint32_t> writer_waiting; // 生产者因空间不足在等待消费者腾出空间
+            alignas(64) std::atomic<uint64_t> head; // 消费者写
+            std::atomic<uint32_t> reader_idle; // 消费者没有数据可读, 准备睡眠
+        };
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "共享内存中的原子变量必须是无锁的");
+
+    private:
+        Header* header;
+        char* data;
+        size_t capacity; // 2的幂
+
+    public:
+        ShmRing() : header(nullptr), data(nullptr), capacity(0) {}
+
+        // 一个环在共享内存中占用的字节数
+        static size_t region_size(size_t _capacity) {
+            return sizeof(Header) + _capacity;
+        }
+
+        // _base 指向共享内存中的环, _init 为 true 时由创建方初始化头部
+        void attach(void* _base, size_t _capacity, bool _init) {
+            header = static_cast<Header*>(_base);
+            data = static_cast<char*>(_base) + sizeof(Header);
+            capacity = _capacity;
+            if (_init) {
+                new (header) Header();
+                header->tail.store(0);
+                header->head.store(0);
+                header->writer_waiting.store(0);
+                header->reader_idle.store(1);
+            }
+        }
+
+        // ---------- 生产者 ----------
+
+        // 写入尽量多的数据, 返回写入的字节数
+        size_t write(const char* _buf, size_t _len) {
+            uint64_t tail = header->tail.load(std::memory_order_relaxed);
+            uint64_t head = header->head.load(std::memory_order_acquire);
+            size_t len = std::min(_len, capacity - static_cast<size_t>(tail - head));
+            if (len == 0) {
+                return 0;
+            }
+            size_t pos = tail & (capacity - 1);
+            size_t first = std::min(len, capacity - pos);
+            memcpy(data + pos, _buf, first);
+            memcpy(data, _buf + first, len - first);
+            // 与消费者 prepare_idle 中的 store/load 构成 Dekker 式配对, 二者至少有一方能看到对方
+            header->tail.store(tail + len, std::memory_order_seq_cst);
+            return len;
+        }
+
+        // 写入数据后调用, 消费者已经准备睡眠时返回 true, 由调用者通过 eventfd 唤醒
+        // 同一次睡眠只会有一个生产者得到 true
+        bool reader_needs_wakeup() {
+            return header->reader_idle.load(std::memory_order_seq_cst) != 0 && header->reader_idle.exchange(0) != 0;
+        }
+
+        // 环已满, 准备等待消费者腾出空间: 登记等待后重新检查, 返回 true 表示已经有空间, 不必等待
+        bool wait_for_space() {
+            header->writer_waiting.store(1, std::memory_order_seq_cst);
+            if (header->tail.load(std::memory_order_relaxed) - header->head.load(std::memory_order_seq_cst) < capacity) {
+                header->writer_waiting.store(0, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        // ---------- 消费者 ----------
+
+        // 下标由对端进程写入, 限制在容量之内, 对端写坏头部时不会越界读取
+        size_t read_able_size() {
+            size_t len = header->tail.load(std::memory_order_acquire) - header->head.load(std::memory_order_relaxed);
+            return std::min(len, capacity);
+        }
+
+        // 从可读数据的 _offset 处拷贝 _len 字节, 调用者保证数据足够
+        void peek(char* _buf, size_t _len, size_t _offset = 0) {
+            size_t pos = (header->head.load(std::memory_order_relaxed) + _offset) & (capacity - 1);
+            size_t first = std::min(_len, capacity - pos);
+            memcpy(_buf, data + pos, first);
+            memcpy(_buf + first, data, _len - first);
+        }
+
+        // 可读数据所在的连续区间, 绕回时为两段
+        int peek_spans(BaseBuffer::Span* _spans) {
+            size_t len = read_able_size();
+            if (len == 0) {
+                return 0;
+            }
+            size_t pos = header->head.load(std::memory_order_relaxed) & (capacity - 1);
+            size_t first = std::min(len, capacity - pos);
+            _spans[0].data = data + pos;
+            _spans[0].len = first;
+            if (first == len) {
+                return 1;
+            }
+            _spans[1].data = data;
+            _spans[1].len = len - first;
+            return 2;
+        }
+
+        void move_read(size_t _len) {
+            header->head.store(header->head.load(std::memory_order_relaxed) + _len, std::memory_order_seq_cst);
+        }
+
+        // 消费后调用, 生产者在等待空间时返回 true, 由调用者通过 eventfd 唤醒
+        bool writer_needs_wakeup() {
+            return header->writer_waiting.load(std::memory_order_seq_cst) != 0 && header->writer_waiting.exchange(0) != 0;
+        }
+
+        // 剩下的 _seen 字节不足一条消息, 准备回到事件循环睡眠
+        // 登记空闲后重新检查, 返回 false 表示期间又有数据写入, 不能睡眠
+        bool prepare_idle(size_t _seen) {
+            header->reader_idle.store(1, std::memory_order_seq_cst);
+            if (header->tail.load(std::memory_order_seq_cst) - header->head.load(std::memory_order_relaxed) != _seen) {
+                header->reader_idle.store(0, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+
+        // 开始处理数据, 处理期间生产者不必唤醒
+        void leave_idle() {
+            if (header->reader_idle.load(std::memory_order_relaxed) != 0) {
+                header->reader_idle.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // 以消费者身份直接读取共享内存环的缓冲区, 协议层从环中解析消息, 不先拷贝到连接的输入缓冲区
+    class ShmBuffer : public BaseBuffer {
+    private:
+        ShmRing* ring;
+    public:
+        using ptr = std::shared_ptr<ShmBuffer>;
+
+        ShmBuffer(ShmRing* ring) : ring(ring) {}
+
+        virtual size_t read_able_size() override {
+            return ring->read_able_size();
+        }
+
+        virtual int32_t peek_int32() override {
+            if (ring->read_able_size() < sizeof(int32_t)) {
+                LOG_ERROR("缓冲区数据不足，无法读取int32_t类型数据");
+                return 0;
+            }
+            int32_t value = 0;
+            ring->peek(reinterpret_cast<char*>(&value), sizeof(int32_t));
+            return ntohl(value); // 网络字节序转主机字节序
+        }
+
+        // 字节序未转换
+        virtual void retrieve_int32(int32_t& _data) override {
+            if (ring->read_able_size() < sizeof(int32_t)) {
+                LOG_ERROR("缓冲区数据不足，无法读取int32_t类型数据");
+                _data = 0;
+                return;
+            }
+            ring->peek(reinterpret_cast<char*>(&_data), sizeof(int32_t));
+            ring->move_read(sizeof(int32_t));
+        }
+
+        virtual int32_t read_int32() override {
+            int32_t value;
+            retrieve_int32(value);
+            return ntohl(value);
+        }
+
+        virtual std::string retrieve_as_string(size_t len) override {
+            if (ring->read_able_size() < len) {
+                LOG_ERROR("缓冲区数据不足，无法读取指定长度的字符串");
+                len = ring->read_able_size();
+            }
+            std::string str(len, '\0');
+            ring->peek(&str[0], len);
+            ring->move_read(len);
+            return str;
+        }
+
+        virtual void move_read(size_t len) override {
+            if (ring->read_able_size() < len) {
+                LOG_ERROR("缓冲区数据不足，无法丢弃指定长度的数据");
+                len = ring->read_able_size();
+            }
+            ring->move_read(len);
+        }
+
+        virtual int peek_spans(Span* spans) override {
+            return ring->peek_spans(spans);
+        }
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "../abstract/BaseServer.hpp"
+#include "../factory/ProtocolFactory.hpp"
+#include "../muduo/tcp_server/Acceptor.hpp"
+#include "ShmConnection.hpp"
+#include <unordered_set>
+
+namespace rpc {
+    // 同一台机器上的共享内存传输, 地址写作 "shm:<路径>"
+    // 客户端先连接路径上的 unix 套接字, 服务端为每个连接创建一对共享内存环并通过该套接字交给客户端
+    // 之后的请求和响应都只经过共享内存, 所有连接由一个loop线程处理
+    class ShmServer : public BaseServer {
+    private:
+        BaseProtocol::ptr protocol;
+        uint32_t capacity;
+        muduo::EventLoop loop;
+        std::vector<std::unique_ptr<muduo::Acceptor>> acceptors;
+        std::mutex mtx;
+        std::unordered_set<ShmConnection::ptr> connections;
+
+        void new_connection(const muduo::Connection::Info& info) {
+            ShmResource res;
+            res.sock_fd = info.fd;
+            if (!res.create(capacity)) {
+                res.close_all();
+                return;
+            }
+            //描述符交给连接管理, 连接释放时关闭
+            //先初始化两个环再把描述符交给客户端, 客户端拿到时环已经可用
+            auto conn = std::make_shared<ShmConnection>(&loop, protocol, res, true);
+            if (!conn->init(true) || !res.send_handshake()) {
+                return;
+            }
+            conn->set_msg_cb(msg_cb);
+            conn->set_close_cb(std::bind(&ShmServer::on_close, this, std::placeholders::_1));
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                connections.insert(conn);
+            }
+            LOG_INFO("共享内存客户端连接成功!");
+            if (conn_cb) {
+                conn_cb(conn);
+            }
+            conn->established();
+        }
+
+        void on_close(const ShmConnection::ptr& conn) {
+            LOG_INFO("共享内存客户端断开连接!");
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                connections.erase(conn);
+            }
+            if (close_cb) {
+                close_cb(conn);
+            }
+        }
+
+    public:
+        using ptr = std::shared_ptr<ShmServer>;
+
+        // 每个方向的共享内存环默认1MB
+        static constexpr uint32_t default_capacity = 1 << 20;
+
+        static bool is_shm_address(const std::string& ip) {
+            return ip.compare(0, 4, "shm:") == 0;
+        }
+
+        // 把 "shm:<路径>" 转换为握手用的 unix 套接字地址
+        static std::string handshake_address(const std::string& ip) {
+            return "unix:" + ip.substr(4);
+        }
+
+        ShmServer(const std::string& ip, uint32_t _capacity = default_capacity)
+            : protocol(ProtocolFactory::create())
+            , capacity(_capacity) {
+            if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+                LOG_FATAL("共享内存环的容量必须是2的幂: %u", capacity);
+                abort();
+            }
+            add_listen(0, ip);
+        }
+
+        // 只支持额外监听 "shm:<路径>" 形式的地址
+        virtual void add_listen(int /*port*/, const std::string& ip) override {
+            if (!is_shm_address(ip)) {
+                LOG_ERROR("ShmServer 不能监听地址: %s", ip.c_str());
+                return;
+            }
+            auto acceptor = new muduo::Acceptor(&loop, 0, handshake_address(ip));
+            acceptor->set_accept_cb(std::bind(&ShmServer::new_connection, this, std::placeholders::_1));
+            acceptor->listen();
+            acceptors.emplace_back(acceptor);
+        }
+
+        void start() {
+            loop.start();
+        }
+    };
+}
@@ -41,7 +41,8 @@ PROTOBUF_CONSTEXPR RpcRequest::RpcRequest(
     /*decltype(_impl_._has_bits_)*/{}
   , /*decltype(_impl_._cached_size_)*/{}
   , /*decltype(_impl_.params_)*/{}
-  , /*decltype(_impl_.method_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}} {}
+  , /*decltype(_impl_.method_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.method_id_)*/0u} {}
 struct RpcRequestDefaultTypeInternal {
   PROTOBUF_CONSTEXPR RpcRequestDefaultTypeInternal()
       : _instance(::_pbi::ConstantInitialized{}) {}
@@ -88,7 +89,8 @@ PROTOBUF_CONSTEXPR RpcResponse::RpcResponse(
     /*decltype(_impl_._has_bits_)*/{}
   , /*decltype(_impl_._cached_size_)*/{}
   , /*decltype(_impl_.result_)*/nullptr
-  , /*decltype(_impl_.retcode_)*/0} {}
+  , /*decltype(_impl_.retcode_)*/0
+  , /*decltype(_impl_.method_id_)*/0u} {}
 struct RpcResponseDefaultTypeInternal {
   PROTOBUF_CONSTEXPR RpcResponseDefaultTypeInternal()
       : _instance(::_pbi::ConstantInitialized{}) {}
@@ -153,8 +155,10 @@ const uint32_t TableStruct_RpcMessage_2eproto::offsets[] PROTOBUF_SECTION_VARIAB
   ~0u,  // no _inlined_string_donated_
   PROTOBUF_FIELD_OFFSET(::msg::RpcRequest, _impl_.method_),
   PROTOBUF_FIELD_OFFSET(::msg::RpcRequest, _impl_.params_),
+  PROTOBUF_FIELD_OFFSET(::msg::RpcRequest, _impl_.method_id_),
   0,
   ~0u,
+  1,
   PROTOBUF_FIELD_OFFSET(::msg::TopicRequest, _impl_._has_bits_),
   PROTOBUF_FIELD_OFFSET(::msg::TopicRequest, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -187,8 +191,10 @@ const uint32_t TableStruct_RpcMessage_2eproto::offsets[] PROTOBUF_SECTION_VARIAB
   ~0u,  // no _inlined_string_donated_
   PROTOBUF_FIELD_OFFSET(::msg::RpcResponse, _impl_.retcode_),
   PROTOBUF_FIELD_OFFSET(::msg::RpcResponse, _impl_.result_),
+  PROTOBUF_FIELD_OFFSET(::msg::RpcResponse, _impl_.method_id_),
   1,
   0,
+  2,
   PROTOBUF_FIELD_OFFSET(::msg::TopicResponse, _impl_._has_bits_),
   PROTOBUF_FIELD_OFFSET(::msg::TopicResponse, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -214,12 +220,12 @@ const uint32_t TableStruct_RpcMessage_2eproto::offsets[] PROTOBUF_SECTION_VARIAB
 };
 static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
   { 0, 8, -1, sizeof(::msg::Address)},
-  { 10, 18, -1, sizeof(::msg::RpcRequest)},
-  { 20, 29, -1, sizeof(::msg::TopicRequest)},
-  { 32, 41, -1, sizeof(::msg::ServiceRequest)},
-  { 44, 52, -1, sizeof(::msg::RpcResponse)},
-  { 54, 61, -1, sizeof(::msg::TopicResponse)},
-  { 62, 72, -1, sizeof(::msg::ServiceResponse)},
+  { 10, 19, -1, sizeof(::msg::RpcRequest)},
+  { 22, 31, -1, sizeof(::msg::TopicRequest)},
+  { 34, 43, -1, sizeof(::msg::ServiceRequest)},
+  { 46, 55, -1, sizeof(::msg::RpcResponse)},
+  { 58, 65, -1, sizeof(::msg::TopicResponse)},
+  { 66, 76, -1, sizeof(::msg::ServiceResponse)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
@@ -235,30 +241,32 @@ static const ::_pb::Message* const file_default_instances[] = {
 const char descriptor_table_protodef_RpcMessage_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
   "\n\020RpcMessage.proto\022\003msg\032\034google/protobuf"
   "/struct.proto\"=\n\007Address\022\017\n\002ip\030\001 \001(\tH\000\210\001"
-  "\001\022\021\n\004port\030\002 \001(\005H\001\210\001\001B\005\n\003_ipB\007\n\005_port\"T\n\n"
+  "\001\022\021\n\004port\030\002 \001(\005H\001\210\001\001B\005\n\003_ipB\007\n\005_port\"z\n\n"
   "RpcRequest\022\023\n\006method\030\001 \001(\tH\000\210\001\001\022&\n\006param"
-  "s\030\002 \003(\0132\026.google.protobuf.ValueB\t\n\007_meth"
-  "od\"n\n\014TopicRequest\022\022\n\005topic\030\001 \001(\tH\000\210\001\001\022\023"
-  "\n\006optype\030\002 \001(\005H\001\210\001\001\022\024\n\007message\030\003 \001(\tH\002\210\001"
-  "\001B\010\n\006_topicB\t\n\007_optypeB\n\n\010_message\"\200\001\n\016S"
-  "erviceRequest\022\023\n\006method\030\001 \001(\tH\000\210\001\001\022\023\n\006op"
-  "type\030\002 \001(\005H\001\210\001\001\022\"\n\007address\030\003 \001(\0132\014.msg.A"
-  "ddressH\002\210\001\001B\t\n\007_methodB\t\n\007_optypeB\n\n\010_ad"
-  "dress\"g\n\013RpcResponse\022\024\n\007retcode\030\001 \001(\005H\000\210"
-  "\001\001\022+\n\006result\030\002 \001(\0132\026.google.protobuf.Val"
-  "ueH\001\210\001\001B\n\n\010_retcodeB\t\n\007_result\"1\n\rTopicR"
-  "esponse\022\024\n\007retcode\030\001 \001(\005H\000\210\001\001B\n\n\010_retcod"
-  "e\"\222\001\n\017ServiceResponse\022\024\n\007retcode\030\001 \001(\005H\000"
-  "\210\001\001\022\023\n\006method\030\002 \001(\tH\001\210\001\001\022\023\n\006optype\030\003 \001(\005"
-  "H\002\210\001\001\022\035\n\007address\030\004 \003(\0132\014.msg.AddressB\n\n\010"
-  "_retcodeB\t\n\007_methodB\t\n\007_optypeb\006proto3"
+  "s\030\002 \003(\0132\026.google.protobuf.Value\022\026\n\tmetho"
+  "d_id\030\003 \001(\rH\001\210\001\001B\t\n\007_methodB\014\n\n_method_id"
+  "\"n\n\014TopicRequest\022\022\n\005topic\030\001 \001(\tH\000\210\001\001\022\023\n\006"
+  "optype\030\002 \001(\005H\001\210\001\001\022\024\n\007message\030\003 \001(\tH\002\210\001\001B"
+  "\010\n\006_topicB\t\n\007_optypeB\n\n\010_message\"\200\001\n\016Ser"
+  "viceRequest\022\023\n\006method\030\001 \001(\tH\000\210\001\001\022\023\n\006opty"
+  "pe\030\002 \001(\005H\001\210\001\001\022\"\n\007address\030\003 \001(\0132\014.msg.Add"
+  "ressH\002\210\001\001B\t\n\007_methodB\t\n\007_optypeB\n\n\010_addr"
+  "ess\"\215\001\n\013RpcResponse\022\024\n\007retcode\030\001 \001(\005H\000\210\001"
+  "\001\022+\n\006result\030\002 \001(\0132\026.google.protobuf.Valu"
+  "eH\001\210\001\001\022\026\n\tmethod_id\030\003 \001(\rH\002\210\001\001B\n\n\010_retco"
+  "deB\t\n\007_resultB\014\n\n_method_id\"1\n\rTopicResp"
+  "onse\022\024\n\007retcode\030\001 \001(\005H\000\210\001\001B\n\n\010_retcode\"\222"
+  "\001\n\017ServiceResponse\022\024\n\007retcode\030\001 \001(\005H\000\210\001\001"
+  "\022\023\n\006method\030\002 \001(\tH\001\210\001\001\022\023\n\006optype\030\003 \001(\005H\002\210"
+  "\001\001\022\035\n\007address\030\004 \003(\0132\014.msg.AddressB\n\n\010_re"
+  "tcodeB\t\n\007_methodB\t\n\007_optypeb\006proto3"
   ;
 static const ::_pbi::DescriptorTable* const descriptor_table_RpcMessage_2eproto_deps[1] = {
   &::descriptor_table_google_2fprotobuf_2fstruct_2eproto,
 };
 static ::_pbi::once_flag descriptor_table_RpcMessage_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_RpcMessage_2eproto = {
-    false, false, 758, descriptor_table_protodef_RpcMessage_2eproto,
+    false, false, 835, descriptor_table_protodef_RpcMessage_2eproto,
     "RpcMessage.proto",
     &descriptor_table_RpcMessage_2eproto_once, descriptor_table_RpcMessage_2eproto_deps, 1, 7,
     schemas, file_default_instances, TableStruct_RpcMessage_2eproto::offsets,
@@ -535,6 +543,9 @@ class RpcRequest::_Internal {
   static void set_has_method(HasBits* has_bits) {
     (*has_bits)[0] |= 1u;
   }
+  static void set_has_method_id(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
 };
 
 void RpcRequest::clear_params() {
@@ -553,7 +564,8 @@ RpcRequest::RpcRequest(const RpcRequest& from)
       decltype(_impl_._has_bits_){from._impl_._has_bits_}
     , /*decltype(_impl_._cached_size_)*/{}
     , decltype(_impl_.params_){from._impl_.params_}
-    , decltype(_impl_.method_){}};
+    , decltype(_impl_.method_){}
+    , decltype(_impl_.method_id_){}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
   _impl_.method_.InitDefault();
@@ -564,6 +576,7 @@ RpcRequest::RpcRequest(const RpcRequest& from)
     _this->_impl_.method_.Set(from._internal_method(), 
       _this->GetArenaForAllocation());
   }
+  _this->_impl_.method_id_ = from._impl_.method_id_;
   // @@protoc_insertion_point(copy_constructor:msg.RpcRequest)
 }
 
@@ -576,6 +589,7 @@ inline void RpcRequest::SharedCtor(
     , /*decltype(_impl_._cached_size_)*/{}
     , decltype(_impl_.params_){arena}
     , decltype(_impl_.method_){}
+    , decltype(_impl_.method_id_){0u}
   };
   _impl_.method_.InitDefault();
   #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
@@ -613,6 +627,7 @@ void RpcRequest::Clear() {
   if (cached_has_bits & 0x00000001u) {
     _impl_.method_.ClearNonDefaultToEmpty();
   }
+  _impl_.method_id_ = 0u;
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
@@ -647,6 +662,15 @@ const char* RpcRequest::_InternalParse(const char* ptr, ::_pbi::ParseContext* ct
         } else
           goto handle_unusual;
         continue;
+      // optional uint32 method_id = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _Internal::set_has_method_id(&has_bits);
+          _impl_.method_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -695,6 +719,12 @@ uint8_t* RpcRequest::_InternalSerialize(
         InternalWriteMessage(2, repfield, repfield.GetCachedSize(), target, stream);
   }
 
+  // optional uint32 method_id = 3;
+  if (_internal_has_method_id()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(3, this->_internal_method_id(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -718,14 +748,21 @@ size_t RpcRequest::ByteSizeLong() const {
       ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
   }
 
-  // optional string method = 1;
   cached_has_bits = _impl_._has_bits_[0];
-  if (cached_has_bits & 0x00000001u) {
-    total_size += 1 +
-      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
-        this->_internal_method());
-  }
+  if (cached_has_bits & 0x00000003u) {
+    // optional string method = 1;
+    if (cached_has_bits & 0x00000001u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+          this->_internal_method());
+    }
+
+    // optional uint32 method_id = 3;
+    if (cached_has_bits & 0x00000002u) {
+      total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_method_id());
+    }
 
+  }
   return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
@@ -745,8 +782,15 @@ void RpcRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PRO
   (void) cached_has_bits;
 
   _this->_impl_.params_.MergeFrom(from._impl_.params_);
-  if (from._internal_has_method()) {
-    _this->_internal_set_method(from._internal_method());
+  cached_has_bits = from._impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
+    if (cached_has_bits & 0x00000001u) {
+      _this->_internal_set_method(from._internal_method());
+    }
+    if (cached_has_bits & 0x00000002u) {
+      _this->_impl_.method_id_ = from._impl_.method_id_;
+    }
+    _this->_impl_._has_bits_[0] |= cached_has_bits;
   }
   _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
@@ -773,6 +817,7 @@ void RpcRequest::InternalSwap(RpcRequest* other) {
       &_impl_.method_, lhs_arena,
       &other->_impl_.method_, rhs_arena
   );
+  swap(_impl_.method_id_, other->_impl_.method_id_);
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata RpcRequest::GetMetadata() const {
@@ -1409,6 +1454,9 @@ class RpcResponse::_Internal {
   static void set_has_result(HasBits* has_bits) {
     (*has_bits)[0] |= 1u;
   }
+  static void set_has_method_id(HasBits* has_bits) {
+    (*has_bits)[0] |= 4u;
+  }
 };
 
 const ::PROTOBUF_NAMESPACE_ID::Value&
@@ -1432,13 +1480,16 @@ RpcResponse::RpcResponse(const RpcResponse& from)
       decltype(_impl_._has_bits_){from._impl_._has_bits_}
     , /*decltype(_impl_._cached_size_)*/{}
     , decltype(_impl_.result_){nullptr}
-    , decltype(_impl_.retcode_){}};
+    , decltype(_impl_.retcode_){}
+    , decltype(_impl_.method_id_){}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
   if (from._internal_has_result()) {
     _this->_impl_.result_ = new ::PROTOBUF_NAMESPACE_ID::Value(*from._impl_.result_);
   }
-  _this->_impl_.retcode_ = from._impl_.retcode_;
+  ::memcpy(&_impl_.retcode_, &from._impl_.retcode_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.method_id_) -
+    reinterpret_cast<char*>(&_impl_.retcode_)) + sizeof(_impl_.method_id_));
   // @@protoc_insertion_point(copy_constructor:msg.RpcResponse)
 }
 
@@ -1451,6 +1502,7 @@ inline void RpcResponse::SharedCtor(
     , /*decltype(_impl_._cached_size_)*/{}
     , decltype(_impl_.result_){nullptr}
     , decltype(_impl_.retcode_){0}
+    , decltype(_impl_.method_id_){0u}
   };
 }
 
@@ -1483,7 +1535,11 @@ void RpcResponse::Clear() {
     GOOGLE_DCHECK(_impl_.result_ != nullptr);
     _impl_.result_->Clear();
   }
-  _impl_.retcode_ = 0;
+  if (cached_has_bits & 0x00000006u) {
+    ::memset(&_impl_.retcode_, 0, static_cast<size_t>(
+        reinterpret_cast<char*>(&_impl_.method_id_) -
+        reinterpret_cast<char*>(&_impl_.retcode_)) + sizeof(_impl_.method_id_));
+  }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
@@ -1512,6 +1568,15 @@ const char* RpcResponse::_InternalParse(const char* ptr, ::_pbi::ParseContext* c
         } else
           goto handle_unusual;
         continue;
+      // optional uint32 method_id = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _Internal::set_has_method_id(&has_bits);
+          _impl_.method_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -1555,6 +1620,12 @@ uint8_t* RpcResponse::_InternalSerialize(
         _Internal::result(this).GetCachedSize(), target, stream);
   }
 
+  // optional uint32 method_id = 3;
+  if (_internal_has_method_id()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(3, this->_internal_method_id(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -1572,7 +1643,7 @@ size_t RpcResponse::ByteSizeLong() const {
   (void) cached_has_bits;
 
   cached_has_bits = _impl_._has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     // optional .google.protobuf.Value result = 2;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 +
@@ -1585,6 +1656,11 @@ size_t RpcResponse::ByteSizeLong() const {
       total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_retcode());
     }
 
+    // optional uint32 method_id = 3;
+    if (cached_has_bits & 0x00000004u) {
+      total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_method_id());
+    }
+
   }
   return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
@@ -1605,7 +1681,7 @@ void RpcResponse::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PR
   (void) cached_has_bits;
 
   cached_has_bits = from._impl_._has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     if (cached_has_bits & 0x00000001u) {
       _this->_internal_mutable_result()->::PROTOBUF_NAMESPACE_ID::Value::MergeFrom(
           from._internal_result());
@@ -1613,6 +1689,9 @@ void RpcResponse::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PR
     if (cached_has_bits & 0x00000002u) {
       _this->_impl_.retcode_ = from._impl_.retcode_;
     }
+    if (cached_has_bits & 0x00000004u) {
+      _this->_impl_.method_id_ = from._impl_.method_id_;
+    }
     _this->_impl_._has_bits_[0] |= cached_has_bits;
   }
   _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
@@ -1634,8 +1713,8 @@ void RpcResponse::InternalSwap(RpcResponse* other) {
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   swap(_impl_._has_bits_[0], other->_impl_._has_bits_[0]);
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(RpcResponse, _impl_.retcode_)
-      + sizeof(RpcResponse::_impl_.retcode_)
+      PROTOBUF_FIELD_OFFSET(RpcResponse, _impl_.method_id_)
+      + sizeof(RpcResponse::_impl_.method_id_)
       - PROTOBUF_FIELD_OFFSET(RpcResponse, _impl_.result_)>(
           reinterpret_cast<char*>(&_impl_.result_),
           reinterpret_cast<char*>(&other->_impl_.result_));
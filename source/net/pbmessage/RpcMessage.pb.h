@@ -377,6 +377,7 @@ class RpcRequest final :
   enum : int {
     kParamsFieldNumber = 2,
     kMethodFieldNumber = 1,
+    kMethodIdFieldNumber = 3,
   };
   // repeated .google.protobuf.Value params = 2;
   int params_size() const;
@@ -414,6 +415,19 @@ class RpcRequest final :
   std::string* _internal_mutable_method();
   public:
 
+  // optional uint32 method_id = 3;
+  bool has_method_id() const;
+  private:
+  bool _internal_has_method_id() const;
+  public:
+  void clear_method_id();
+  uint32_t method_id() const;
+  void set_method_id(uint32_t value);
+  private:
+  uint32_t _internal_method_id() const;
+  void _internal_set_method_id(uint32_t value);
+  public:
+
   // @@protoc_insertion_point(class_scope:msg.RpcRequest)
  private:
   class _Internal;
@@ -426,6 +440,7 @@ class RpcRequest final :
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
     ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::PROTOBUF_NAMESPACE_ID::Value > params_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr method_;
+    uint32_t method_id_;
   };
   union { Impl_ _impl_; };
   friend struct ::TableStruct_RpcMessage_2eproto;
@@ -941,6 +956,7 @@ class RpcResponse final :
   enum : int {
     kResultFieldNumber = 2,
     kRetcodeFieldNumber = 1,
+    kMethodIdFieldNumber = 3,
   };
   // optional .google.protobuf.Value result = 2;
   bool has_result() const;
@@ -973,6 +989,19 @@ class RpcResponse final :
   void _internal_set_retcode(int32_t value);
   public:
 
+  // optional uint32 method_id = 3;
+  bool has_method_id() const;
+  private:
+  bool _internal_has_method_id() const;
+  public:
+  void clear_method_id();
+  uint32_t method_id() const;
+  void set_method_id(uint32_t value);
+  private:
+  uint32_t _internal_method_id() const;
+  void _internal_set_method_id(uint32_t value);
+  public:
+
   // @@protoc_insertion_point(class_scope:msg.RpcResponse)
  private:
   class _Internal;
@@ -985,6 +1014,7 @@ class RpcResponse final :
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
     ::PROTOBUF_NAMESPACE_ID::Value* result_;
     int32_t retcode_;
+    uint32_t method_id_;
   };
   union { Impl_ _impl_; };
   friend struct ::TableStruct_RpcMessage_2eproto;
@@ -1566,6 +1596,34 @@ RpcRequest::params() const {
   return _impl_.params_;
 }
 
+// optional uint32 method_id = 3;
+inline bool RpcRequest::_internal_has_method_id() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000002u) != 0;
+  return value;
+}
+inline bool RpcRequest::has_method_id() const {
+  return _internal_has_method_id();
+}
+inline void RpcRequest::clear_method_id() {
+  _impl_.method_id_ = 0u;
+  _impl_._has_bits_[0] &= ~0x00000002u;
+}
+inline uint32_t RpcRequest::_internal_method_id() const {
+  return _impl_.method_id_;
+}
+inline uint32_t RpcRequest::method_id() const {
+  // @@protoc_insertion_point(field_get:msg.RpcRequest.method_id)
+  return _internal_method_id();
+}
+inline void RpcRequest::_internal_set_method_id(uint32_t value) {
+  _impl_._has_bits_[0] |= 0x00000002u;
+  _impl_.method_id_ = value;
+}
+inline void RpcRequest::set_method_id(uint32_t value) {
+  _internal_set_method_id(value);
+  // @@protoc_insertion_point(field_set:msg.RpcRequest.method_id)
+}
+
 // -------------------------------------------------------------------
 
 // TopicRequest
@@ -2043,6 +2101,34 @@ inline void RpcResponse::set_allocated_result(::PROTOBUF_NAMESPACE_ID::Value* re
   // @@protoc_insertion_point(field_set_allocated:msg.RpcResponse.result)
 }
 
+// optional uint32 method_id = 3;
+inline bool RpcResponse::_internal_has_method_id() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000004u) != 0;
+  return value;
+}
+inline bool RpcResponse::has_method_id() const {
+  return _internal_has_method_id();
+}
+inline void RpcResponse::clear_method_id() {
+  _impl_.method_id_ = 0u;
+  _impl_._has_bits_[0] &= ~0x00000004u;
+}
+inline uint32_t RpcResponse::_internal_method_id() const {
+  return _impl_.method_id_;
+}
+inline uint32_t RpcResponse::method_id() const {
+  // @@protoc_insertion_point(field_get:msg.RpcResponse.method_id)
+  return _internal_method_id();
+}
+inline void RpcResponse::_internal_set_method_id(uint32_t value) {
+  _impl_._has_bits_[0] |= 0x00000004u;
+  _impl_.method_id_ = value;
+}
+inline void RpcResponse::set_method_id(uint32_t value) {
+  _internal_set_method_id(value);
+  // @@protoc_insertion_point(field_set:msg.RpcResponse.method_id)
+}
+
 // -------------------------------------------------------------------
 
 // TopicResponse
@@ -16,12 +16,12 @@ namespace rpc
             const PBFieldDescriptor* params_field = descriptor->FindFieldByName(key::params);
             // 如果method字段不存在，或者method类型不是string，则返回false
             if (!method_field || method_field->cpp_type() != PBFieldDescriptor::CPPTYPE_STRING) {
-                logging.error("RpcRequest 方法名字段不存在或类型不是string!");
+                LOG_ERROR("RpcRequest 方法名字段不存在或类型不是string!");
                 return false;
             }
             // 如果params字段存在，且类型不为PBValue，则返回false
             if (params_field && params_field->cpp_type() != PBFieldDescriptor::CPPTYPE_MESSAGE) {
-                logging.error("RpcRequest 参数字段存在但类型不是PBValue!");
+                LOG_ERROR("RpcRequest 参数字段存在但类型不是PBValue!");
                 return false;
             }
             return true;
@@ -39,6 +39,17 @@ namespace rpc
             message->GetReflection()->SetString(message.get(), method_field, _method);
         }
 
+        // 每次调用都会访问, 字段描述只查找一次
+        uint32_t get_method_id() {
+            static const PBFieldDescriptor* method_id_field = msg::RpcRequest::descriptor()->FindFieldByName(key::method_id);
+            return message->GetReflection()->GetUInt32(*message, method_id_field);
+        }
+
+        void set_method_id(uint32_t _method_id) {
+            static const PBFieldDescriptor* method_id_field = msg::RpcRequest::descriptor()->FindFieldByName(key::method_id);
+            message->GetReflection()->SetUInt32(message.get(), method_id_field, _method_id);
+        }
+
         std::vector<PBValue> get_params() {
             const auto* descriptor = message->GetDescriptor();
             const auto* params_field = descriptor->FindFieldByName(key::params);
@@ -16,12 +16,12 @@ namespace rpc
             const PBFieldDescriptor* result_field = descriptor->FindFieldByName("result");
             // 返回码字段存在，并且返回码类型为int32
             if (!retcode_field || retcode_field->cpp_type() != PBFieldDescriptor::CPPTYPE_INT32) {
-                logging.error("RpcResponse 返回码为空或类型错误!");
+                LOG_ERROR("RpcResponse 返回码为空或类型错误!");
                 return false;
             }
             // 结果字段存在，并且结果类型为 google::protobuf::Value
             if (!result_field || result_field->message_type() != google::protobuf::Value::descriptor()) {
-                logging.error("RpcResponse 返回结果为空或类型错误!");
+                LOG_ERROR("RpcResponse 返回结果为空或类型错误!");
                 return false;
             }
             return true;
@@ -40,5 +40,16 @@ namespace rpc
             const PBFieldDescriptor* result_field = descriptor->FindFieldByName("result");
             message->GetReflection()->MutableMessage(message.get(), result_field)->CopyFrom(_result);
         }
+
+        // 为0表示服务端没有告知方法编号
+        uint32_t get_method_id() {
+            static const PBFieldDescriptor* method_id_field = msg::RpcResponse::descriptor()->FindFieldByName(key::method_id);
+            return message->GetReflection()->GetUInt32(*message, method_id_field);
+        }
+
+        void set_method_id(uint32_t _method_id) {
+            static const PBFieldDescriptor* method_id_field = msg::RpcResponse::descriptor()->FindFieldByName(key::method_id);
+            message->GetReflection()->SetUInt32(message.get(), method_id_field, _method_id);
+        }
     };
 }
\ No newline at end of file
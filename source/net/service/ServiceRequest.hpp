@@ -17,15 +17,15 @@ namespace rpc
             const PBFieldDescriptor* optype_field = descriptor->FindFieldByName(key::optype);
             const PBFieldDescriptor* address_field = descriptor->FindFieldByName(key::address);
             if (!method_field || method_field->cpp_type() != PBFieldDescriptor::CPPTYPE_STRING) {
-                logging.error("ServiceRequest 服务名称为空!");
+                LOG_ERROR("ServiceRequest 服务名称为空!");
                 return false;
             }
             if (!optype_field || optype_field->cpp_type() != PBFieldDescriptor::CPPTYPE_INT32) {
-                logging.error("ServiceRequest 操作类型为空!");
+                LOG_ERROR("ServiceRequest 操作类型为空!");
                 return false;
             }
             if (!address_field || address_field->cpp_type() != PBFieldDescriptor::CPPTYPE_MESSAGE) {
-                logging.error("ServiceRequest 地址为空!");
+                LOG_ERROR("ServiceRequest 地址为空!");
                 return false;
             }
             return true;
@@ -16,12 +16,12 @@ namespace rpc
             const PBFieldDescriptor* optype_field = descriptor->FindFieldByName("optype");
             // 返回码字段存在，并且返回码类型为int32
             if (!retcode_field || retcode_field->cpp_type() != PBFieldDescriptor::CPPTYPE_INT32) {
-                logging.error("RpcResponse 返回码为空或类型错误!");
+                LOG_ERROR("RpcResponse 返回码为空或类型错误!");
                 return false;
             }
             // 操作类型字段存在，并且操作类型类型为int32
             if (!optype_field || optype_field->cpp_type() != PBFieldDescriptor::CPPTYPE_INT32) {
-                logging.error("RpcResponse 操作类型为空或类型错误!");
+                LOG_ERROR("RpcResponse 操作类型为空或类型错误!");
                 return false;
             }
             // 操作类型为DISCOVERY，方法名和地址列表必须存在
@@ -29,18 +29,18 @@ namespace rpc
             if (reflection->GetInt32(*message, optype_field) == static_cast<int>(ServiceOptype::DISCOVERY)) {
                 // 服务名字段不存在
                 if (!reflection->HasField(*message, descriptor->FindFieldByName("method"))) {
-                    logging.error("RpcResponse 发现服务请求, 方法名为空!");
+                    LOG_ERROR("RpcResponse 发现服务请求, 方法名为空!");
                     return false;
                 }
                 // 地址字段不存在或者地址字段不为repeated string
                 if(!reflection->HasField(*message, descriptor->FindFieldByName("address")))
                 {
-                    logging.error("RpcResponse 发现服务请求, 地址列表为空!");
+                    LOG_ERROR("RpcResponse 发现服务请求, 地址列表为空!");
                     return false;
                 }
                 const PBFieldDescriptor* address_field = descriptor->FindFieldByName("address");
                 if (address_field->cpp_type() != PBFieldDescriptor::CPPTYPE_MESSAGE) {
-                    logging.error("RpcResponse 发现服务请求, 地址列表类型错误!");
+                    LOG_ERROR("RpcResponse 发现服务请求, 地址列表类型错误!");
                     return false;
                 }
             }
@@ -17,12 +17,12 @@ namespace rpc
             const PBFieldDescriptor* optype_field = descriptor->FindFieldByName(key::optype);
             // 如果topic字段不存在，或者类型不为stirng，则返回false
             if(!topic_field || topic_field->type() != PBFieldDescriptor::TYPE_STRING) {
-                logging.error("TopicRequest 主题名称字段不存在或类型不为string!");
+                LOG_ERROR("TopicRequest 主题名称字段不存在或类型不为string!");
                 return false;
             }
             // 如果optype字段不存在，或者类型不为int32，则返回false
             if(!optype_field || optype_field->type() != PBFieldDescriptor::TYPE_INT32) {
-                logging.error("TopicRequest 操作类型字段不存在或类型不正确!");
+                LOG_ERROR("TopicRequest 操作类型字段不存在或类型不正确!");
                 return false;
             }
             // 如果操作类型为发布消息，则message字段必须存在且类型为string
@@ -31,7 +31,7 @@ namespace rpc
                 // 如果message字段不存在，或者类型不为string，则返回false
                 const PBFieldDescriptor* message_field = descriptor->FindFieldByName(key::message);
                 if(!message_field || message_field->type() != PBFieldDescriptor::TYPE_STRING) {
-                    logging.error("TopicRequest 发布消息字段不存在或类型不为string!");
+                    LOG_ERROR("TopicRequest 发布消息字段不存在或类型不为string!");
                     return false;
                 }
             }
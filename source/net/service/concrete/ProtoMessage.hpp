@@ -4,7 +4,9 @@
 #include <google/protobuf/any.pb.h>
 #include <google/protobuf/message.h>
 #include <google/protobuf/util/json_util.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
 #include "../../../util/Log.hpp"
+#include <unistd.h>
 
 namespace rpc
 {
@@ -16,6 +18,46 @@ namespace rpc
 
     using Address = std::pair<std::string, int>;
 
+    // 本机 unix 套接字的地址写作 {"unix://<主机名><路径>", 0}, 共享内存传输写作 {"shm://<主机名><路径>", 0}
+    // 传输层只使用其中的路径, 主机名用于服务发现时判断提供者是否与自己在同一台机器上
+    inline const std::string& local_hostname() {
+        static const std::string hostname = []() {
+            char buf[256] = {0};
+            if (gethostname(buf, sizeof(buf) - 1) != 0) {
+                return std::string("localhost");
+            }
+            return std::string(buf);
+        }();
+        return hostname;
+    }
+
+    inline Address make_unix_address(const std::string& path) {
+        return Address("unix://" + local_hostname() + path, 0);
+    }
+
+    inline Address make_shm_address(const std::string& path) {
+        return Address("shm://" + local_hostname() + path, 0);
+    }
+
+    // 只能在提供者所在的机器上连接的地址
+    inline bool is_local_transport(const Address& addr) {
+        return addr.first.compare(0, 5, "unix:") == 0 || addr.first.compare(0, 4, "shm:") == 0;
+    }
+
+    // 是否为本机可以直接连接的地址, 没有写主机名的 "unix:<路径>" / "shm:<路径>" 也视为本机
+    inline bool is_local_address(const Address& addr) {
+        if (!is_local_transport(addr)) {
+            return false;
+        }
+        size_t start = addr.first.find(':') + 1;
+        if (addr.first.compare(start, 2, "//") != 0) {
+            return true;
+        }
+        start += 2;
+        size_t end = addr.first.find('/', start);
+        return end != std::string::npos && addr.first.compare(start, end - start, local_hostname()) == 0;
+    }
+
     class ProtoMessage : public BaseMessage
     {
     protected:
@@ -33,7 +75,7 @@ namespace rpc
                 return str;
             }
             else {
-                logging.error("protobuf序列化失败!");
+                LOG_ERROR("protobuf序列化失败!");
                 return "";
             }
         }
@@ -43,9 +85,35 @@ namespace rpc
                 return true;
             }
             else {
-                logging.error("protobuf反序列化失败!");
+                LOG_ERROR("protobuf反序列化失败!");
                 return false;
             }
         }
+        // ByteSizeLong 会缓存各个字段的大小, serialize_to 直接使用缓存的大小编码, 只遍历一次消息
+        virtual size_t byte_size() override {
+            return message->ByteSizeLong();
+        }
+        virtual char* serialize_to(char* out) override {
+            uint8_t* begin = reinterpret_cast<uint8_t*>(out);
+            return reinterpret_cast<char*>(message->SerializeWithCachedSizesToArray(begin));
+        }
+        // 数据连续时直接解析, 绕回成两段时通过 ConcatenatingInputStream 依次读取, 都不拷贝数据
+        virtual bool deserialize(const BaseBuffer::Span* view, int count) override {
+            bool ok;
+            if (count <= 1) {
+                ok = message->ParseFromArray(count ? view[0].data : nullptr, count ? view[0].len : 0);
+            }
+            else {
+                google::protobuf::io::ArrayInputStream first(view[0].data, view[0].len);
+                google::protobuf::io::ArrayInputStream second(view[1].data, view[1].len);
+                google::protobuf::io::ZeroCopyInputStream* streams[2] = { &first, &second };
+                google::protobuf::io::ConcatenatingInputStream input(streams, 2);
+                ok = message->ParseFromZeroCopyStream(&input);
+            }
+            if (!ok) {
+                LOG_ERROR("protobuf反序列化失败!");
+            }
+            return ok;
+        }
     };
 }
\ No newline at end of file
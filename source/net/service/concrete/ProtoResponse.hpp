@@ -15,7 +15,7 @@ namespace rpc
             const PBFieldDescriptor* retcode_field = descriptor->FindFieldByName(key::retcode);
             // 如果消息类型不包含retcode字段，或者retcode字段类型不是int32，则返回false
             if (retcode_field == nullptr || retcode_field->cpp_type() != PBFieldDescriptor::CPPTYPE_INT32) {
-                logging.error("Response retcode字段不存在或类型不正确!");
+                LOG_ERROR("Response retcode字段不存在或类型不正确!");
                 return false;
             }
             return true;
@@ -2,6 +2,7 @@
 
 #include "RpcRouter.hpp"
 #include "../util/uuid.hpp"
+#include <algorithm>
 
 namespace rpc {
     namespace server {
@@ -15,15 +16,21 @@ namespace rpc {
 
                 std::mutex mtx;
                 BaseConnection::ptr connection;
-                Address host;
+                std::vector<Address> hosts; // 提供者通告的所有地址(如TCP和本机unix套接字), 所有方法共用
                 std::vector<std::string> methods;
 
-                Provider(const BaseConnection::ptr& _connection, const Address& _host)
-                    : connection(_connection), host(_host) {}
+                Provider(const BaseConnection::ptr& _connection)
+                    : connection(_connection) {}
 
-                void append_method(const std::string& _method) {
+                // 同一方法以不同地址注册多次时只记录一次
+                void append(const std::string& _method, const Address& _host) {
                     std::lock_guard<std::mutex> lock(mtx);
-                    methods.push_back(_method);
+                    if (std::find(hosts.begin(), hosts.end(), _host) == hosts.end()) {
+                        hosts.push_back(_host);
+                    }
+                    if (std::find(methods.begin(), methods.end(), _method) == methods.end()) {
+                        methods.push_back(_method);
+                    }
                 }
             };
 
@@ -37,12 +44,12 @@ namespace rpc {
                         provider = it->second;
                     }
                     else {
-                        provider = std::make_shared<Provider>(_connection, _host);
+                        provider = std::make_shared<Provider>(_connection);
                         connection_provider[_connection] = provider;
                     }
                     method_provider[_method].insert(provider);
                 }
-                provider->append_method(_method);
+                provider->append(_method, _host);
             }
 
             // 提供者断连注销服务
@@ -76,7 +83,8 @@ namespace rpc {
                     return hosts;
                 }
                 for(auto& provider : it->second) {
-                    hosts.push_back(provider->host);
+                    std::lock_guard<std::mutex> provider_lock(provider->mtx);
+                    hosts.insert(hosts.end(), provider->hosts.begin(), provider->hosts.end());
                 }
                 return hosts;
             }
@@ -154,12 +162,17 @@ namespace rpc {
                     return;
                 }
                 auto msg_req = MessageFactory::create<ServiceRequest>();
-                msg_req->set_id(UUID::ramdom());
+                msg_req->set_id(UUID::next_id());
                 msg_req->set_type(MsgType::REQ_SERVICE);
                 msg_req->set_method(_method);
                 msg_req->set_address(_host);
                 msg_req->set_optype(_optype);
                 for(auto& discoverer : it->second) {
+                    // 发现者的发送缓冲区已经积压, 丢弃本次通知, 不再继续堆积
+                    if (discoverer->connection->is_congested()) {
+                        LOG_WARNING("DiscovererManager::notify 发现者连接积压, 丢弃 %s 的上下线通知", _method.c_str());
+                        continue;
+                    }
                     discoverer->connection->send(msg_req);
                 }
             }
@@ -182,24 +195,24 @@ namespace rpc {
             void on_service_request(const BaseConnection::ptr _connection, const ServiceRequest::ptr _req) {
                 // 先检查请求是否合法
                 if (!_req->check()) {
-                    logging.error("PDManager::on_service_request 请求格式错误: %s", _req->get_method().c_str());
+                    LOG_ERROR("PDManager::on_service_request 请求格式错误: %s", _req->get_method().c_str());
                     return;
                 }                
                 ServiceOptype optype = _req->get_optype();
                 if (optype == ServiceOptype::REGISTRY) {
-                    logging.debug("PDManager::on_service_request: %s:%d 服务注册请求, method: %s", _req->get_address().first.c_str(), _req->get_address().second, _req->get_method().c_str());
+                    LOG_DEBUG("PDManager::on_service_request: %s:%d 服务注册请求, method: %s", _req->get_address().first.c_str(), _req->get_address().second, _req->get_method().c_str());
                     provider_manager->add_provider(_connection, _req->get_address(), _req->get_method());
                     discoverer_manager->online_notify(_req->get_method(), _req->get_address());
                     registry_response(_connection, _req);
                 }
                 else if (optype == ServiceOptype::DISCOVERY) {
-                    logging.debug("PDManager::on_service_request: %s:%d 服务发现请求, method: %s", _req->get_address().first.c_str(), _req->get_address().second, _req->get_method().c_str());
+                    LOG_DEBUG("PDManager::on_service_request: %s:%d 服务发现请求, method: %s", _req->get_address().first.c_str(), _req->get_address().second, _req->get_method().c_str());
                     discoverer_manager->add_discoverer(_connection, _req->get_method());
                     discovery_response(_connection, _req);
                 }
                 else {
                     error_response(_connection, _req);
-                    logging.error("PDManager::on_service_request: 错误的服务操作类型");
+                    LOG_ERROR("PDManager::on_service_request: 错误的服务操作类型");
                 }
             }
 
@@ -207,7 +220,9 @@ namespace rpc {
                 auto provider = provider_manager->get_provider(_connection);
                 if (provider) {
                     for(auto& method : provider->methods) {
-                        discoverer_manager->offline_notify(method, provider->host);
+                        for(auto& host : provider->hosts) {
+                            discoverer_manager->offline_notify(method, host);
+                        }
                     }
                     provider_manager->del_provider(_connection);
                 }
@@ -216,7 +231,7 @@ namespace rpc {
         private:
             void registry_response(const BaseConnection::ptr _connection, const ServiceRequest::ptr _req) {
                 auto msg_rsp = MessageFactory::create<ServiceResponse>();
-                msg_rsp->set_id(_req->get_id());
+                msg_rsp->set_id_from(*_req);
                 msg_rsp->set_type(MsgType::RSP_SERVICE);
                 msg_rsp->set_optype(ServiceOptype::REGISTRY);
                 msg_rsp->set_retcode(RetCode::SUCCESS);
@@ -225,7 +240,7 @@ namespace rpc {
 
             void discovery_response(const BaseConnection::ptr _connection, const ServiceRequest::ptr _req) {
                 auto msg_rsp = MessageFactory::create<ServiceResponse>();
-                msg_rsp->set_id(_req->get_id());
+                msg_rsp->set_id_from(*_req);
                 msg_rsp->set_type(MsgType::RSP_SERVICE);
                 msg_rsp->set_optype(ServiceOptype::DISCOVERY);
                 std::vector<Address> hosts = provider_manager->get_method_hosts(_req->get_method());
@@ -242,7 +257,7 @@ namespace rpc {
 
             void error_response(const BaseConnection::ptr _connection, const ServiceRequest::ptr _req) {
                 auto msg_rsp = MessageFactory::create<ServiceResponse>();
-                msg_rsp->set_id(_req->get_id());
+                msg_rsp->set_id_from(*_req);
                 msg_rsp->set_type(MsgType::RSP_SERVICE);
                 msg_rsp->set_optype(ServiceOptype::SERVICE_UNKNOW);
                 msg_rsp->set_retcode(RetCode::INVALID_OPTYPE);
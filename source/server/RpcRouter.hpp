@@ -32,6 +32,15 @@ namespace rpc {
                 return method_name;
             }
 
+            // 由 ServiceManager 分配, 0 表示尚未注册
+            uint32_t get_method_id() const {
+                return method_id;
+            }
+
+            void set_method_id(uint32_t _method_id) {
+                method_id = _method_id;
+            }
+
             bool param_check(const std::vector<PBValue>& _params) {
                 // 检查参数个数
                 if (_params.size() != params_desc.size()) {
@@ -78,6 +87,7 @@ namespace rpc {
 
         private:
             std::string method_name;
+            uint32_t method_id = 0;
             std::vector<ParamsDescribe> params_desc;
             ValueType return_type;
             ServiceCallBack callback; 
@@ -113,13 +123,32 @@ namespace rpc {
         };
 
         // 服务管理器类
+        // 每个方法注册时分配一个从1开始的编号, 同名方法重新注册时沿用原来的编号
+        // 客户端知道编号后按编号调用, 查找时直接下标访问, 不再对方法名做哈希
         class ServiceManager {
         public:
             using ptr = std::shared_ptr<ServiceManager>;
 
             void insert(const ServiceDiscribe::ptr& _desc) {
                 std::lock_guard<std::mutex> lock(mtx);
+                auto it = services.find(_desc->get_method_name());
+                if (it != services.end()) {
+                    _desc->set_method_id(it->second->get_method_id());
+                }
+                else {
+                    by_id.emplace_back();
+                    _desc->set_method_id(by_id.size() - 1);
+                }
                 services[_desc->get_method_name()] = _desc;
+                by_id[_desc->get_method_id()] = _desc;
+            }
+
+            ServiceDiscribe::ptr select(uint32_t _method_id) {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (_method_id < by_id.size()) {
+                    return by_id[_method_id];
+                }
+                return nullptr;
             }
 
             ServiceDiscribe::ptr select(const std::string& _method_name) {
@@ -133,12 +162,18 @@ namespace rpc {
 
             void remove(const std::string& _method_name) {
                 std::lock_guard<std::mutex> lock(mtx);
-                services.erase(_method_name);
+                auto it = services.find(_method_name);
+                if (it != services.end()) {
+                    //编号不回收, 已经缓存了编号的客户端会得到 NOT_FOUND_SERVICE
+                    by_id[it->second->get_method_id()].reset();
+                    services.erase(it);
+                }
             }
 
         private:
             std::mutex mtx;
             std::unordered_map<std::string, ServiceDiscribe::ptr> services;
+            std::vector<ServiceDiscribe::ptr> by_id = std::vector<ServiceDiscribe::ptr>(1); // 下标为编号, 0 号不使用
         };
 
         // RPC路由器类, 负责处理RPC请求和响应
@@ -152,32 +187,49 @@ namespace rpc {
             void on_rpc_request(const BaseConnection::ptr& _conn, const RpcRequest::ptr& _req) {
                 // 检查请求
                 if (!_req->check()) {
-                    logging.error("RpcRouter::on_rpc_request RPC请求格式错误: %s", _req->get_method().c_str());
+                    LOG_ERROR("RpcRouter::on_rpc_request RPC请求格式错误: %s", _req->get_method().c_str());
                     response(_conn, _req, PBValue(), RetCode::INVALID_MSG);
                     return;
                 }
-                // 查询服务
-                ServiceDiscribe::ptr service = service_manager->select(_req->get_method());
+                // 发往该客户端的响应已经积压到高水位, 不再执行新的请求, 只返回一个很小的错误响应
+                if (_conn->is_congested()) {
+                    if (_req->get_method_id() != 0) {
+                        LOG_WARNING("RpcRouter::on_rpc_request 连接响应积压, 丢弃请求, 方法编号: %u", _req->get_method_id());
+                    }
+                    else {
+                        LOG_WARNING("RpcRouter::on_rpc_request 连接响应积压, 丢弃请求: %s", _req->get_method().c_str());
+                    }
+                    response(_conn, _req, PBValue(), RetCode::OVERLOADED);
+                    return;
+                }
+                // 查询服务, 带有编号时按编号查找, 否则按方法名查找并在响应中告知编号
+                uint32_t method_id = _req->get_method_id();
+                ServiceDiscribe::ptr service = method_id != 0 ? service_manager->select(method_id) : service_manager->select(_req->get_method());
                 if (!service.get()) {
-                    logging.error("RpcRouter::on_rpc_request RPC方法不存在: %s", _req->get_method().c_str());
+                    if (method_id != 0) {
+                        LOG_ERROR("RpcRouter::on_rpc_request RPC方法编号不存在: %u", method_id);
+                    }
+                    else {
+                        LOG_ERROR("RpcRouter::on_rpc_request RPC方法不存在: %s", _req->get_method().c_str());
+                    }
                     response(_conn, _req, PBValue(), RetCode::NOT_FOUND_SERVICE);
                     return;
                 }
                 // 检查参数
                 if (!service->param_check(_req->get_params())) {
-                    logging.error("RpcRouter::on_rpc_request RPC参数错误: %s", _req->get_method().c_str());
+                    LOG_ERROR("RpcRouter::on_rpc_request RPC参数错误: %s", service->get_method_name().c_str());
                     response(_conn, _req, PBValue(), RetCode::INVALID_PARAMS);
                     return;
                 }
                 // 调用回调
                 PBValue result;
                 if (!service->excute_callback(_req->get_params(), result)) {
-                    logging.error("RpcRouter::on_rpc_request RPC回调执行失败: %s", _req->get_method().c_str());
+                    LOG_ERROR("RpcRouter::on_rpc_request RPC回调执行失败: %s", service->get_method_name().c_str());
                     response(_conn, _req, PBValue(), RetCode::INTERNAL_ERROR);
                     return;
                 }
                 // 返回结果
-                response(_conn, _req, result, RetCode::SUCCESS);
+                response(_conn, _req, result, RetCode::SUCCESS, method_id == 0 ? service->get_method_id() : 0);
             }
 
             void register_method(const ServiceDiscribe::ptr& _service) {
@@ -185,12 +237,15 @@ namespace rpc {
             }
 
         private:
-            void response(const BaseConnection::ptr& _conn, const RpcRequest::ptr& _req, const PBValue& _result, RetCode _retcode) {
+            void response(const BaseConnection::ptr& _conn, const RpcRequest::ptr& _req, const PBValue& _result, RetCode _retcode, uint32_t _method_id = 0) {
                 RpcResponse::ptr rsp = MessageFactory::create<RpcResponse>();
-                rsp->set_id(_req->get_id());
+                rsp->set_id_from(*_req);
                 rsp->set_type(MsgType::RSP_RPC);
                 rsp->set_retcode(_retcode);
                 rsp->set_result(_result);
+                if (_method_id != 0) {
+                    rsp->set_method_id(_method_id);
+                }
                 _conn->send(rsp);
             }
         private:
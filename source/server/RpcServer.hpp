@@ -7,6 +7,23 @@
 
 namespace rpc {
     namespace server {
+        // 发送缓冲区的默认高低水位
+        static const size_t default_high_water_mark = 64 * 1024 * 1024;
+        static const size_t default_low_water_mark = 16 * 1024 * 1024;
+
+        // 对端不读取响应导致发送缓冲区到达高水位时暂停读取它的请求, 回落到低水位后恢复
+        static void enable_backpressure(const BaseConnection::ptr& conn, size_t high, size_t low) {
+            auto high_cb = [](const BaseConnection::ptr& _conn, size_t _pending) {
+                LOG_WARNING("连接发送缓冲区积压 %zu 字节, 暂停读取", _pending);
+                _conn->pause_read();
+            };
+            auto low_cb = [](const BaseConnection::ptr& _conn, size_t _pending) {
+                LOG_INFO("连接发送缓冲区回落到 %zu 字节, 恢复读取", _pending);
+                _conn->resume_read();
+            };
+            conn->set_water_mark(high, low, high_cb, low_cb);
+        }
+
         class RegistryServer {
         public:
             using ptr = std::shared_ptr<RegistryServer>;
@@ -14,6 +31,8 @@ namespace rpc {
             RegistryServer(const Address& host)
                 : pd_manager(std::make_shared<PDManager>())
                 , dispatcher(std::make_shared<Dispatcher>())
+                , high_water_mark(default_high_water_mark)
+                , low_water_mark(default_low_water_mark)
             {
                 auto service_cb = std::bind(&PDManager::on_service_request, pd_manager, std::placeholders::_1, std::placeholders::_2);
                 dispatcher->register_handler<ServiceRequest>(MsgType::REQ_SERVICE, service_cb);
@@ -23,12 +42,24 @@ namespace rpc {
                 server->set_message_cb(msg_cb);
                 auto close_cb = std::bind(&RegistryServer::on_connection_shutdown, this, std::placeholders::_1);
                 server->set_close_cb(close_cb);
+                auto conn_cb = std::bind(&RegistryServer::on_connected, this, std::placeholders::_1);
+                server->set_connected_cb(conn_cb);
+            }
+
+            // 需在 start 之前调用
+            void set_water_mark(size_t high, size_t low) {
+                high_water_mark = high;
+                low_water_mark = low;
             }
 
             void start() {
                 server->start();
             }
         private:
+            void on_connected(const BaseConnection::ptr& conn) {
+                enable_backpressure(conn, high_water_mark, low_water_mark);
+            }
+
             void on_connection_shutdown(const BaseConnection::ptr& conn) {
                 pd_manager->on_connection_shutdown(conn);
             }
@@ -36,6 +67,8 @@ namespace rpc {
             PDManager::ptr pd_manager;
             Dispatcher::ptr dispatcher;
             BaseServer::ptr server;
+            size_t high_water_mark;
+            size_t low_water_mark;
         };
 
         class RpcServer {
@@ -43,10 +76,12 @@ namespace rpc {
             using ptr = std::shared_ptr<RpcServer>;
  
             RpcServer(const Address& _host, bool _enable_registry = false, const Address& _registry_host = Address())
-                : access_host(_host)
+                : access_hosts(1, _host)
                 , enable_registry(_enable_registry)
                 , router(std::make_shared<RpcRouter>())
                 , dispatcher(std::make_shared<Dispatcher>())
+                , high_water_mark(default_high_water_mark)
+                , low_water_mark(default_low_water_mark)
             {
                 if (enable_registry) {
                     registry_client = std::make_shared<client::RegistryClient>(_registry_host.first, _registry_host.second);
@@ -55,29 +90,73 @@ namespace rpc {
                 auto rpc_cb = std::bind(&RpcRouter::on_rpc_request, router, std::placeholders::_1, std::placeholders::_2);
                 dispatcher->register_handler<RpcRequest>(MsgType::REQ_RPC, rpc_cb);
 
-                server = ServerFactory::create(access_host.second, access_host.first);
+                server = ServerFactory::create(_host.second, _host.first);
                 auto msg_cb = std::bind(&Dispatcher::on_message, dispatcher, std::placeholders::_1, std::placeholders::_2);
                 server->set_message_cb(msg_cb);
+                auto conn_cb = std::bind(&RpcServer::on_connected, this, std::placeholders::_1);
+                server->set_connected_cb(conn_cb);
+            }
+
+            // 需在 start 之前调用
+            void set_water_mark(size_t high, size_t low) {
+                high_water_mark = high;
+                low_water_mark = low;
+            }
+
+            // 不小于 threshold 字节的响应以零拷贝方式发送, 需在 start 之前调用
+            void enable_zerocopy(size_t threshold) {
+                server->enable_zerocopy(threshold);
+            }
+
+            // 同时在本机 unix 套接字 path 上提供服务, 并向注册中心通告该地址
+            // 同一台机器上的客户端通过服务发现会优先连接它, 需在 register_method 和 start 之前调用
+            void enable_unix_socket(const std::string& path) {
+                Address unix_host = make_unix_address(path);
+                server->add_listen(unix_host.second, unix_host.first);
+                access_hosts.push_back(unix_host);
+            }
+
+            // 同时通过本机共享内存提供服务, path 为握手用的 unix 套接字路径, 并向注册中心通告该地址
+            // 共享内存服务端使用独立的loop线程, 需在 register_method 和 start 之前调用
+            void enable_shm(const std::string& path) {
+                Address shm_host = make_shm_address(path);
+                BaseServer::ptr shm_server = ServerFactory::create(shm_host.second, shm_host.first);
+                shm_server->set_message_cb(std::bind(&Dispatcher::on_message, dispatcher, std::placeholders::_1, std::placeholders::_2));
+                shm_server->set_connected_cb(std::bind(&RpcServer::on_connected, this, std::placeholders::_1));
+                extra_servers.push_back(shm_server);
+                access_hosts.push_back(shm_host);
             }
 
             void register_method(const ServiceDiscribe::ptr& service_discribe) {
                 if (enable_registry) {
-                    logging.debug("RpcServer::register_method 向 %s:%d 注册了method: %s", access_host.first.c_str(), access_host.second, service_discribe->get_method_name().c_str());
-                    registry_client->registry_method(service_discribe->get_method_name(), access_host);
+                    for (auto& host : access_hosts) {
+                        LOG_DEBUG("RpcServer::register_method 向 %s:%d 注册了method: %s", host.first.c_str(), host.second, service_discribe->get_method_name().c_str());
+                        registry_client->registry_method(service_discribe->get_method_name(), host);
+                    }
                 }
                 router->register_method(service_discribe);
             }
 
             void start() {
+                for (auto& extra : extra_servers) {
+                    std::thread([extra]() { extra->start(); }).detach();
+                }
                 server->start();
             }
         private:
-            Address access_host;
+            void on_connected(const BaseConnection::ptr& conn) {
+                enable_backpressure(conn, high_water_mark, low_water_mark);
+            }
+
+            std::vector<Address> access_hosts; // 第一个为构造时指定的地址, 之后为 enable_unix_socket/enable_shm 添加的地址
             bool enable_registry;
             client::RegistryClient::ptr registry_client;
             RpcRouter::ptr router;
             Dispatcher::ptr dispatcher;
             BaseServer::ptr server;
+            std::vector<BaseServer::ptr> extra_servers; // enable_shm 添加的服务端, 各自在独立线程中运行
+            size_t high_water_mark;
+            size_t low_water_mark;
         };
     }
 }
\ No newline at end of file
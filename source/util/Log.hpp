@@ -11,6 +11,82 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <pthread.h>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <condition_variable>
+#include <algorithm>
+#include <cerrno>
+
+// 每个线程独占一个日志环, 所属线程只写 tail, 刷盘线程只写 head, 不需要加锁
+// 每条日志在环中存为 Record 头部加上日志内容
+class LogRing {
+public:
+    static constexpr size_t capacity = 1 << 16; // 2的幂
+
+    struct Record {
+        uint32_t len;
+        uint32_t level;
+    };
+
+    std::atomic<bool> alive; // 所属线程退出后置为 false, 刷盘线程取完剩下的日志后释放
+
+private:
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) std::atomic<uint64_t> head;
+    char data[capacity];
+
+    void copy_in(uint64_t pos, const void* buf, size_t len) {
+        size_t off = pos & (capacity - 1);
+        size_t first = std::min(len, capacity - off);
+        memcpy(data + off, buf, first);
+        memcpy(data, static_cast<const char*>(buf) + first, len - first);
+    }
+
+public:
+    LogRing() : alive(true), tail(0), head(0) {}
+
+    // 空间不足时返回 false, 不会写入半条日志
+    bool push(int level, const char* text, size_t len) {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        if (capacity - (t - head.load(std::memory_order_acquire)) < sizeof(Record) + len) {
+            return false;
+        }
+        Record record{ static_cast<uint32_t>(len), static_cast<uint32_t>(level) };
+        copy_in(t, &record, sizeof(Record));
+        copy_in(t + sizeof(Record), text, len);
+        tail.store(t + sizeof(Record) + len, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed);
+    }
+
+    // 取出环中所有的日志, 绕回的日志分两次交给 sink(level, text, len)
+    template <typename Sink>
+    void drain(Sink&& sink) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        uint64_t t = tail.load(std::memory_order_acquire);
+        while (h != t) {
+            Record record;
+            size_t off = h & (capacity - 1);
+            size_t first = std::min(sizeof(Record), capacity - off);
+            memcpy(&record, data + off, first);
+            memcpy(reinterpret_cast<char*>(&record) + first, data, sizeof(Record) - first);
+            off = (h + sizeof(Record)) & (capacity - 1);
+            first = std::min<size_t>(record.len, capacity - off);
+            sink(record.level, data + off, first);
+            if (first < record.len) {
+                sink(record.level, data, record.len - first);
+            }
+            h += sizeof(Record) + record.len;
+        }
+        head.store(h, std::memory_order_release);
+    }
+};
 
 class Log {
 public:
@@ -27,12 +103,33 @@ private:
     std::mutex log_mutex;
 
     const int buffer_size = 1024;
+    static constexpr int level_count = 5;
+    static constexpr int flush_interval_ms = 50; // 刷盘线程空闲时的最长等待时间
 
     std::string log_file;
     int log_level;
 
+    // ---------- 异步刷盘 ----------
+    // 写日志的线程只在自己的日志环中格式化并追加, 由后台线程批量写出, 文件一直保持打开
+    std::once_flag start_flag;
+    std::thread flusher;
+    std::atomic<bool> running;
+    std::mutex ring_mutex; // 保护 rings
+    std::vector<std::shared_ptr<LogRing>> rings;
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    std::condition_variable flushed_cv;
+    uint64_t flush_request; // flush() 请求的轮次
+    uint64_t flush_done; // 刷盘线程已经完成的轮次
+    bool wake_pending;
+
+    // 刷盘线程使用
+    std::string batch[level_count]; // CLASSFILE 时每个级别一批, 其余模式只用 batch[0]
+    std::unordered_map<std::string, int> files; // 已经打开的日志文件
+    int file_day;
+
 private:
-    std::string level_to_string(int level) {
+    const char* level_to_string(int level) {
         switch (level) {
             case 0: return "Debug";
             case 1: return "Info";
@@ -43,64 +140,224 @@ private:
         }
     }
 
-    void printLog(const std::string& levelName, const std::string& logtxt) {
-        switch (print_method) {
-            case SCREEN:
-                std::cout << logtxt;
-                break;
-            case ONEFILE:
-                print_one_file(log_file, logtxt);
-                break;
-            case CLASSFILE:
-                print_class_file(levelName, logtxt);
-                break;
-            default:
-                break;
+    // 日志文件名带日期, 按天切换
+    std::string file_name(int level, const struct tm& now) {
+        char date[32];
+        snprintf(date, sizeof(date), "%02d-%02d-%02d_", now.tm_year + 1900, now.tm_mon + 1, now.tm_mday);
+        std::string name = path + date + log_file;
+        if (print_method == CLASSFILE) {
+            name += ".";
+            name += level_to_string(level);
         }
+        return name;
     }
 
-    void print_one_file(const std::string& logname, const std::string& logtxt) {
-        std::lock_guard<std::mutex> lock(log_mutex);
+    static void write_all(int fd, const char* buf, size_t len) {
+        while (len > 0) {
+            ssize_t n = ::write(fd, buf, len);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            buf += n;
+            len -= n;
+        }
+    }
+
+    void close_files() {
+        for (auto& file : files) {
+            ::close(file.second);
+        }
+        files.clear();
+    }
+
+    // 把一批日志写到级别对应的位置, 文件只在第一次使用或者日期变化后打开
+    void output(int level, const std::string& logtxt, const struct tm& now) {
+        if (print_method == SCREEN) {
+            write_all(STDOUT_FILENO, logtxt.data(), logtxt.size());
+            return;
+        }
+        if (now.tm_yday != file_day) {
+            close_files();
+            file_day = now.tm_yday;
+        }
+        std::string name = file_name(level, now);
+        auto it = files.find(name);
+        if (it == files.end()) {
+            int fd = open(name.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+            if (fd < 0)
+                return;
+            it = files.emplace(name, fd).first;
+        }
+        write_all(it->second, logtxt.data(), logtxt.size());
+    }
 
+    // 刷盘线程停止之后的日志直接写出
+    void output_direct(int level, const char* logtxt, size_t len) {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        if (print_method == SCREEN) {
+            write_all(STDOUT_FILENO, logtxt, len);
+            return;
+        }
         time_t t = time(nullptr);
-        struct tm* ctime = localtime(&t);
-        char buffer[buffer_size];
-        snprintf(buffer, sizeof(buffer), "%02d-%02d-%02d_", ctime->tm_year + 1900, ctime->tm_mon + 1, ctime->tm_mday);
-        std::string _logname = path + buffer;
-        int fd = open(_logname.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0666);
+        struct tm now;
+        localtime_r(&t, &now);
+        int fd = open(file_name(level, now).c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
         if (fd < 0)
             return;
-        ssize_t ret = write(fd, logtxt.c_str(), logtxt.size());
-        close(fd);
+        write_all(fd, logtxt, len);
+        ::close(fd);
     }
 
-    void print_class_file(const std::string& levelName, const std::string& logtxt) {
-        std::string filename = log_file;
-        filename += ".";
-        filename += levelName;
-        print_one_file(filename, logtxt);
+    // 取出所有线程的日志并写出, 返回取到的字节数
+    size_t flush_rings() {
+        std::vector<std::shared_ptr<LogRing>> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(ring_mutex);
+            snapshot = rings;
+        }
+        bool classfile = print_method == CLASSFILE;
+        size_t total = 0;
+        bool has_dead = false;
+        for (auto& ring : snapshot) {
+            //先读 alive 再取数据, 线程退出前写入的日志一定能取到
+            if (!ring->alive.load(std::memory_order_acquire)) {
+                has_dead = true;
+            }
+            ring->drain([&](int level, const char* text, size_t len) {
+                batch[classfile ? level : 0].append(text, len);
+                total += len;
+            });
+        }
+        if (has_dead) {
+            std::lock_guard<std::mutex> lock(ring_mutex);
+            for (size_t i = 0; i < rings.size();) {
+                if (!rings[i]->alive.load(std::memory_order_acquire) && rings[i]->size() == 0) {
+                    rings[i] = rings.back();
+                    rings.pop_back();
+                }
+                else {
+                    i++;
+                }
+            }
+        }
+        if (total == 0) {
+            return 0;
+        }
+        time_t t = time(nullptr);
+        struct tm now;
+        localtime_r(&t, &now);
+        for (int level = 0; level < level_count; level++) {
+            if (!batch[level].empty()) {
+                output(level, batch[level], now);
+                batch[level].clear();
+            }
+        }
+        return total;
     }
 
-    void log_message(const std::string& levelName, const char* format, va_list args) {
-        time_t t = time(nullptr);
-        struct tm* ctime = localtime(&t);
-        char leftbuffer[buffer_size];
+    void flush_loop() {
+        while (true) {
+            uint64_t request;
+            {
+                std::unique_lock<std::mutex> lock(wake_mutex);
+                request = flush_request;
+            }
+            size_t flushed = flush_rings();
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            flush_done = request;
+            flushed_cv.notify_all();
+            if (!running.load(std::memory_order_acquire)) {
+                break;
+            }
+            //本轮取到了数据说明写得很快, 直接开始下一轮
+            if (flushed == 0 && !wake_pending && flush_request == request) {
+                wake_cv.wait_for(lock, std::chrono::milliseconds(flush_interval_ms));
+            }
+            wake_pending = false;
+        }
+        //取出停止之前写入的日志
+        flush_rings();
+        close_files();
+    }
 
-        snprintf(leftbuffer, sizeof(leftbuffer), "[%s][thread: %p][%02d:%02d:%02d]", levelName.c_str(),
-                 (void*)pthread_self(), ctime->tm_hour, ctime->tm_min, ctime->tm_sec);
+    void wake_flusher() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            wake_pending = true;
+        }
+        wake_cv.notify_one();
+    }
 
-        char rightbuffer[buffer_size];
-        vsnprintf(rightbuffer, sizeof(rightbuffer), format, args);
+    // 线程退出时通知刷盘线程释放该线程的日志环
+    struct RingHolder {
+        std::shared_ptr<LogRing> ring;
+        ~RingHolder() {
+            if (ring) {
+                ring->alive.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    // 日志环按线程分配, 只供全局的 logging 使用
+    LogRing* local_ring() {
+        static thread_local RingHolder holder;
+        if (!holder.ring) {
+            std::call_once(start_flag, [this]() {
+                running.store(true, std::memory_order_release);
+                flusher = std::thread(&Log::flush_loop, this);
+            });
+            holder.ring = std::make_shared<LogRing>();
+            std::lock_guard<std::mutex> lock(ring_mutex);
+            rings.push_back(holder.ring);
+        }
+        return holder.ring.get();
+    }
+
+    void printLog(int level, const char* logtxt, size_t len) {
+        LogRing* ring = local_ring();
+        while (running.load(std::memory_order_acquire)) {
+            if (ring->push(level, logtxt, len)) {
+                //超过一半时提前唤醒, 平时由刷盘线程定时取出
+                if (ring->size() > LogRing::capacity / 2) {
+                    wake_flusher();
+                }
+                return;
+            }
+            //环已满, 等刷盘线程腾出空间, 不丢日志
+            wake_flusher();
+            std::this_thread::yield();
+        }
+        output_direct(level, logtxt, len);
+    }
+
+    void log_message(int level, const char* format, va_list args) {
+        //同一秒内的日志复用格式化好的时间
+        static thread_local time_t cached_second = -1;
+        static thread_local char cached_time[16];
+        static thread_local void* thread_id = (void*)pthread_self();
+        time_t t = time(nullptr);
+        if (t != cached_second) {
+            struct tm now;
+            localtime_r(&t, &now);
+            snprintf(cached_time, sizeof(cached_time), "%02d:%02d:%02d", now.tm_hour, now.tm_min, now.tm_sec);
+            cached_second = t;
+        }
 
         char logtxt[buffer_size * 2 + 1];
-        snprintf(logtxt, sizeof(logtxt), "%s %s\n", leftbuffer, rightbuffer);
+        int len = snprintf(logtxt, sizeof(logtxt), "[%s][thread: %p][%s] ", level_to_string(level), thread_id, cached_time);
+        int n = vsnprintf(logtxt + len, buffer_size, format, args);
+        len += std::min(std::max(n, 0), buffer_size - 1);
+        logtxt[len++] = '\n';
 
-        std::lock_guard<std::mutex> lock(log_mutex); // 同样在这里加锁
-        printLog(levelName, logtxt);
+        printLog(level, logtxt, len);
     }
 
 public:
-    Log() : print_method(SCREEN), log_file("log.txt"), log_level(0) {
+    Log() : print_method(SCREEN), log_file("log.txt"), log_level(0)
+        , running(false), flush_request(0), flush_done(0), wake_pending(false), file_day(-1) {
         char* home = getenv("HOME");
         if (home != nullptr) {
             path = home;
@@ -110,6 +367,25 @@ public:
         }
     }
 
+    // 进程退出时写出剩下的日志, 之后的日志直接写出
+    ~Log() {
+        if (running.exchange(false)) {
+            wake_flusher();
+            flusher.join();
+        }
+    }
+
+    // 等待此前写入的日志全部写出
+    void flush() {
+        if (!running.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        uint64_t request = ++flush_request;
+        wake_cv.notify_one();
+        flushed_cv.wait(lock, [&]() { return flush_done >= request || !running.load(); });
+    }
+
     void set_print_method(PRINT_STATUS method) {
         print_method = method;
     }
@@ -129,12 +405,16 @@ public:
         log_level = level_map[level];
     }
 
+    // 运行时是否输出该级别的日志, 供 LOG_xxx 宏在求值参数之前判断
+    bool enabled(int level) const {
+        return level >= log_level;
+    }
 
     void debug(const char* format, ...) {
         if(log_level > 0) return; // 只在 log_level 为 0 时打印 Debug 日志
         va_list args;
         va_start(args, format);
-        log_message("Debug", format, args);
+        log_message(0, format, args);
         va_end(args);
     }
 
@@ -142,7 +422,7 @@ public:
         if(log_level > 1) return; // 只在 log_level 为 1 时打印 Info 日志
         va_list args;
         va_start(args, format);
-        log_message("Info", format, args);
+        log_message(1, format, args);
         va_end(args);
     }
 
@@ -150,7 +430,7 @@ public:
         if(log_level > 2) return; // 只在 log_level 为 2 时打印 Warning 日志
         va_list args;
         va_start(args, format);
-        log_message("Warning", format, args);
+        log_message(2, format, args);
         va_end(args);
     }
 
@@ -158,7 +438,7 @@ public:
         if(log_level > 3) return; // 只在 log_level 为 3 时打印 Error 日志
         va_list args;
         va_start(args, format);
-        log_message("Error", format, args);
+        log_message(3, format, args);
         va_end(args);
     }
 
@@ -166,9 +446,30 @@ public:
         if(log_level > 4) return; // 只在 log_level 为 4 时打印 Fatal 日志
         va_list args;
         va_start(args, format);
-        log_message("Fatal", format, args);
+        log_message(4, format, args);
         va_end(args);
+        flush(); // 调用者随后通常会 abort, 先把日志写出
     }
 };
 
-Log logging;
\ No newline at end of file
+Log logging;
+
+// 编译期的最低日志级别, 低于该级别的日志连同参数一起被编译掉, 例如 -DLOG_MIN_LEVEL=1 去掉所有 debug 日志
+// 0: debug, 1: info, 2: warning, 3: error, 4: fatal
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+// 先判断级别再求值参数, 被过滤的日志不会执行参数中的函数调用和字符串拷贝
+#define LOG_AT(level, method, ...) \
+    do { \
+        if ((level) >= LOG_MIN_LEVEL && logging.enabled(level)) { \
+            logging.method(__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(0, debug, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(1, info, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(2, warning, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(3, error, __VA_ARGS__)
+#define LOG_FATAL(...) LOG_AT(4, fatal, __VA_ARGS__)
\ No newline at end of file
@@ -1,35 +1,75 @@
 #pragma once
-#include <sstream>
-#include <iomanip>
+#include <string>
 #include <random>
 #include <atomic>
+#include <cstring>
 
 class UUID {
-public:
-     static std::string ramdom() {
-        std::stringstream ss;
-        // 构造一个随机数生成器
+private:
+     // 每个线程一次从全局序号中取走的 ID 个数, 线程之间不必争用同一个原子变量
+     static constexpr uint64_t id_block = 1024;
+
+     static uint64_t random_seed() {
         std::random_device rd;
-        // 使用随机数生成器初始化一个均匀分布的整数生成器
-        std::mt19937 generator(rd());
-        // 生成8个随机数
-        std::uniform_int_distribution<int> distribution(0, 255);
-        for (int i = 0; i < 8; ++i) {
-            // 生成一个随机数
-            int random_number = distribution(generator);
-            // 将随机数转换为16进制字符串并添加到字符串流中
-            ss << std::hex << std::setw(2) << std::setfill('0') << random_number;
-        }
-        ss << '-';
-        static std::atomic<size_t> id(1);
-        size_t cur = id.fetch_add(1);
-        // 将当前id转换为16进制字符串并添加到字符串流中
-        for(int i = 7; i >= 0; i--) {
-            if (i == 5) {
-                ss << '-';
+        return (static_cast<uint64_t>(rd()) << 32) | rd();
+     }
+
+     // 0x00~0xff 对应的两位十六进制字符
+     static const char* hex_table() {
+        static const std::string table = []() {
+            const char* digits = "0123456789abcdef";
+            std::string str(512, '0');
+            for (int i = 0; i < 256; i++) {
+                str[i * 2] = digits[i >> 4];
+                str[i * 2 + 1] = digits[i & 0xF];
             }
-            ss << std::setw(2) << std::setfill('0') << std::hex << ((cur >> (i * 8)) & 0xFF);
+            return str;
+        }();
+        return table.data();
+     }
+
+public:
+     // ramdom 生成的字符串长度
+     static constexpr size_t ramdom_size = 34;
+
+     // 把 value 写成16位十六进制(高位在前)
+     static void to_hex(uint64_t value, char* out) {
+        const char* table = hex_table();
+        for (int i = 7; i >= 0; i--) {
+            memcpy(out + i * 2, table + (value & 0xFF) * 2, 2);
+            value >>= 8;
         }
-        return ss.str();
      }
-};
\ No newline at end of file
+
+     // 请求的64位 ID, 从进程启动时的随机数开始递增, 同一个进程内不会重复, 不需要格式化
+     static uint64_t next_id() {
+        static std::atomic<uint64_t> seq(random_seed());
+        static thread_local uint64_t cur = 0;
+        static thread_local uint64_t end = 0;
+        if (cur == end) {
+            cur = seq.fetch_add(id_block, std::memory_order_relaxed);
+            end = cur + id_block;
+        }
+        return cur++;
+     }
+
+     // 16位随机数-4位序号-12位序号, 写入 out 开始的 ramdom_size 个字符
+     // 随机数生成器每个线程只初始化一次
+     static void ramdom(char* out) {
+        static thread_local std::mt19937_64 generator(random_seed());
+        static std::atomic<uint64_t> id(1);
+        char seq[16];
+        to_hex(generator(), out);
+        to_hex(id.fetch_add(1, std::memory_order_relaxed), seq);
+        out[16] = '-';
+        memcpy(out + 17, seq, 4);
+        out[21] = '-';
+        memcpy(out + 22, seq + 4, 12);
+     }
+
+     static std::string ramdom() {
+        std::string str(ramdom_size, '\0');
+        ramdom(&str[0]);
+        return str;
+     }
+};